@@ -0,0 +1,98 @@
+#include <po.h>
+#include <chrono>
+#include <iostream>
+
+// Replays recorded job specs through one schema, once line by line with parse_command_line like a replay loop
+// would and once with parse_batch on 1 to N threads
+static po::detail::parser parser;
+static po::flag verbose{po::ParentGroup(parser), po::ShortName('v'), po::LongName("verbose")};
+static po::argument<std::string_view> name{po::ParentGroup(parser), po::ShortName('n'), po::LongName("name")};
+static po::argument<std::uint32_t> priority{po::ParentGroup(parser), po::ShortName('p'), po::LongName("priority"), po::Def<std::uint32_t>(0)};
+static po::argument<double> memory{po::ParentGroup(parser), po::LongName("memory"), po::Def<double>(1.0)};
+static po::multi_argument<std::string> env{po::ParentGroup(parser), po::ShortName('e'), po::LongName("env"), po::Min(0), po::Max(std::size_t(-1))};
+static po::multi_positional_argument<> files{po::ParentGroup(parser), po::Min(0)};
+
+static void
+    make_lines(std::size_t count, std::vector<std::string>& storage, std::vector<std::vector<std::string_view>>& lines)
+{
+    storage.reserve(count * 8);
+    lines.resize(count);
+    for (std::size_t i = 0; i < count; i++)
+    {
+        std::size_t first = storage.size();
+        storage.push_back("job_" + std::to_string(i));
+        storage.push_back(std::to_string(i % 10));
+        storage.push_back(std::to_string((i % 64) * 0.5 + 0.25));
+        storage.push_back("PATH=/opt/jobs/" + std::to_string(i % 97) + "/bin");
+        storage.push_back("/data/jobs/" + std::to_string(i) + "/input.dat");
+        auto& line = lines[i];
+        line = {"jobd", "--name", storage[first], "-p", storage[first + 1], "--memory=" , "-e", storage[first + 3],
+            "--env=HOME=/home/job", storage[first + 4], "/data/common/config.json"};
+        storage.push_back("--memory=" + storage[first + 2]);
+        line[5] = storage.back();
+        if (i % 4 == 0)
+        {
+            line.insert(line.begin() + 1, "-v");
+        }
+    }
+}
+
+template <class F>
+static double
+    run(std::size_t iterations, F&& f)
+{
+    auto start = std::chrono::steady_clock::now();
+    for (std::size_t i = 0; i < iterations; i++)
+    {
+        f();
+    }
+    std::chrono::duration<double> d = std::chrono::steady_clock::now() - start;
+    return d.count() / iterations;
+}
+
+static void
+    print(const std::string& title, std::size_t count, double seconds, double base)
+{
+    std::cout << std::left << std::setw(34) << title
+        << std::right << std::setw(10) << std::fixed << std::setprecision(2) << seconds * 1e3 << " ms"
+        << std::setw(10) << std::setprecision(2) << count / seconds / 1e6 << " Mlines/s"
+        << std::setw(8) << std::setprecision(2) << base / seconds << "x\n";
+}
+
+int main(int argc, const char** argv)
+{
+    std::size_t count = argc > 1 ? po::lexical_cast<std::size_t>(argv[1]) : 200000;
+    std::size_t iterations = argc > 2 ? po::lexical_cast<std::size_t>(argv[2]) : 5;
+    std::size_t max_threads = argc > 3 ? po::lexical_cast<std::size_t>(argv[3]) : std::max(1u, std::thread::hardware_concurrency());
+    std::vector<std::string> storage;
+    std::vector<std::vector<std::string_view>> lines;
+    make_lines(count, storage, lines);
+    std::size_t checksum = 0;
+
+    std::cout << count << " job specs, " << std::thread::hardware_concurrency() << " hardware threads\n";
+    double base = run(iterations, [&]
+        {
+            for (const auto& line : lines)
+            {
+                parser.parse_command_line(line);
+                parser.notify();
+                checksum += priority + files.parsed_count();
+            }
+        });
+    print("parse_command_line per line", count, base, base);
+    for (std::size_t threads = 1; threads <= max_threads; threads *= 2)
+    {
+        double seconds = run(iterations, [&]
+            {
+                auto batch = parser.parse_batch(lines, threads);
+                const auto& priorities = batch[priority];
+                for (std::size_t i = 0; i < batch.size(); i++)
+                {
+                    checksum += priorities[i] + batch[files][i].size();
+                }
+            });
+        print("parse_batch, " + std::to_string(threads) + " threads", count, seconds, base);
+    }
+    std::cout << "checksum " << checksum << "\n";
+    return 0;
+}
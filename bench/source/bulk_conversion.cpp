@@ -0,0 +1,87 @@
+#include <po.h>
+#include <chrono>
+#include <iostream>
+
+// Converts 1M values of multi_argument<double> and multi_argument<std::filesystem::path>, serially inside the
+// parse loop and with po::Parallel after it. The parallel pass converts one slice per core on the shared worker
+// pool. On a single core, and for paths, which allocate, po::Parallel converts inside the parse loop as well
+static po::detail::parser parser;
+static po::multi_argument<double> serial_doubles{po::ParentGroup(parser), po::LongName("sd"), po::Min(0), po::Max(std::size_t(-1))};
+static po::multi_argument<double> parallel_doubles{po::ParentGroup(parser), po::LongName("pd"), po::Min(0), po::Max(std::size_t(-1)), po::Parallel(65536)};
+static po::multi_argument<std::filesystem::path> serial_paths{po::ParentGroup(parser), po::LongName("sp"), po::Min(0), po::Max(std::size_t(-1))};
+static po::multi_argument<std::filesystem::path> parallel_paths{po::ParentGroup(parser), po::LongName("pp"), po::Min(0), po::Max(std::size_t(-1)), po::Parallel(65536)};
+
+template <class F>
+static void
+    run(const char* title, std::size_t iterations, std::size_t count, F&& f)
+{
+    auto start = std::chrono::steady_clock::now();
+    for (std::size_t i = 0; i < iterations; i++)
+    {
+        f();
+    }
+    std::chrono::duration<double> d = std::chrono::steady_clock::now() - start;
+    std::cout << std::left << std::setw(34) << title
+        << std::right << std::setw(10) << std::fixed << std::setprecision(2) << d.count() * 1e3 / iterations << " ms"
+        << std::setw(10) << std::setprecision(1) << d.count() * 1e9 / iterations / count << " ns/arg\n";
+}
+
+static std::vector<std::string_view>
+    make_args(std::vector<std::string>& storage, std::string_view option, std::size_t count, bool path)
+{
+    std::vector<std::string_view> result{"prog"};
+    for (std::size_t i = 0; i < count; i++)
+    {
+        if (path)
+        {
+            storage.push_back("--" + std::string(option) + "=/data/run/" + std::to_string(i % 977) + "/sample_" + std::to_string(i) + ".bin");
+        }
+        else
+        {
+            storage.push_back("--" + std::string(option) + "=" + std::to_string(i * 0.001 + 1e-7));
+        }
+    }
+    for (std::size_t i = storage.size() - count; i < storage.size(); i++)
+    {
+        result.push_back(storage[i]);
+    }
+    return result;
+}
+
+int main(int argc, const char** argv)
+{
+    std::size_t count = argc > 1 ? po::lexical_cast<std::size_t>(argv[1]) : 1000000;
+    std::size_t iterations = argc > 2 ? po::lexical_cast<std::size_t>(argv[2]) : 5;
+    std::vector<std::string> storage;
+    storage.reserve(count * 4);
+    auto sd = make_args(storage, "sd", count, false);
+    auto pd = make_args(storage, "pd", count, false);
+    auto sp = make_args(storage, "sp", count, true);
+    auto pp = make_args(storage, "pp", count, true);
+    auto result = parser.make_result();
+    std::size_t checksum = 0;
+
+    std::cout << count << " values, " << std::thread::hardware_concurrency() << " hardware threads\n";
+    run("multi_argument<double>", iterations, count, [&]
+        {
+            parser.parse(sd, result);
+            checksum += result[serial_doubles].size();
+        });
+    run("multi_argument<double> parallel", iterations, count, [&]
+        {
+            parser.parse(pd, result);
+            checksum += result[parallel_doubles].size();
+        });
+    run("multi_argument<path>", iterations, count, [&]
+        {
+            parser.parse(sp, result);
+            checksum += result[serial_paths].size();
+        });
+    run("multi_argument<path> parallel", iterations, count, [&]
+        {
+            parser.parse(pp, result);
+            checksum += result[parallel_paths].size();
+        });
+    std::cout << "checksum " << checksum << "\n";
+    return 0;
+}
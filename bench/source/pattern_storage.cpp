@@ -0,0 +1,64 @@
+#include <po.h>
+#include <chrono>
+#include <iostream>
+
+// Parses many --define-<key>=<value> arguments into each storage policy of multi_pattern_argument and looks every
+// key up again
+static po::detail::parser parser;
+static po::multi_pattern_argument<std::string_view, std::string_view> ordered{po::ParentGroup(parser), po::Pattern("o-*"), po::Min(0)};
+static po::multi_pattern_argument<std::string_view, std::string_view, po::flat_storage> flat{po::ParentGroup(parser), po::Pattern("f-*"), po::Min(0)};
+static po::multi_pattern_argument<std::string_view, std::string_view, po::hash_storage> hashed{po::ParentGroup(parser), po::Pattern("h-*"), po::Min(0)};
+
+template <class F>
+static void
+    run(const char* title, std::size_t iterations, std::size_t count, F&& f)
+{
+    auto start = std::chrono::steady_clock::now();
+    for (std::size_t i = 0; i < iterations; i++)
+    {
+        f();
+    }
+    std::chrono::duration<double> d = std::chrono::steady_clock::now() - start;
+    std::cout << std::left << std::setw(34) << title
+        << std::right << std::setw(10) << std::fixed << std::setprecision(2) << d.count() * 1e3 / iterations << " ms"
+        << std::setw(10) << std::setprecision(1) << d.count() * 1e9 / iterations / count << " ns/arg\n";
+}
+
+template <class Option>
+static void
+    bench(const char* title, const Option& option, char prefix, std::size_t count, std::size_t iterations, std::size_t& checksum)
+{
+    std::vector<std::string> storage;
+    std::vector<std::string_view> args{"prog"};
+    std::vector<std::string> keys;
+    for (std::size_t i = 0; i < count; i++)
+    {
+        keys.push_back("key." + std::to_string((i * 7919) % count));
+        storage.push_back(std::string("--") + prefix + "-" + keys.back() + "=" + std::to_string(i));
+    }
+    args.insert(args.end(), storage.begin(), storage.end());
+    auto result = parser.make_arena_result(count * 256);
+    run(title, iterations, count, [&]
+        {
+            parser.parse(args, result);
+            auto& values = result[option];
+            for (auto& key : keys)
+            {
+                checksum += values.find(std::string_view(key))->second.size();
+            }
+        });
+}
+
+int main(int argc, const char** argv)
+{
+    std::size_t count = argc > 1 ? po::lexical_cast<std::size_t>(argv[1]) : 100000;
+    std::size_t iterations = argc > 2 ? po::lexical_cast<std::size_t>(argv[2]) : 10;
+    std::size_t checksum = 0;
+
+    std::cout << count << " pattern arguments, parse and look up every key\n";
+    bench("ordered_storage (std::pmr::map)", ordered, 'o', count, iterations, checksum);
+    bench("flat_storage", flat, 'f', count, iterations, checksum);
+    bench("hash_storage", hashed, 'h', count, iterations, checksum);
+    std::cout << "checksum " << checksum << "\n";
+    return 0;
+}
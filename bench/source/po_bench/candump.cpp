@@ -0,0 +1,12 @@
+// The schema of test/source/candump.cpp, its main is renamed so it doesn't clash with the one of po_bench
+#include "harness.h"
+#include <iostream>
+#define main candump_main
+#include "../../../test/source/candump.cpp"
+#undef main
+
+bench::schema
+    bench::candump_schema()
+{
+    return {"candump", &parser, {{"candump", "-c", "-c", "-ta", "can0,123:7FF,400:700,#000000FF", "can2,400~7F0", "can3", "can8"}}};
+}
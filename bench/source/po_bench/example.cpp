@@ -0,0 +1,14 @@
+// The schema of test/source/example.cpp, its main is renamed so it doesn't clash with the one of po_bench
+#include "harness.h"
+#include <iostream>
+#include <filesystem>
+#define main example_main
+#include "../../../test/source/example.cpp"
+#undef main
+
+bench::schema
+    bench::example_schema()
+{
+    return {"example", &parser, {{"example", "--pflag1-can0", "--parg1-asdf=1.1", "--parg1-qwer=2.2", "group1", "--arg2=2",
+        "group2", "--arg3=3", "group3", "--flag1", "--marg1=file1.txt", "--marg1=file2.txt"}}, true};
+}
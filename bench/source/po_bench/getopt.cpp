@@ -0,0 +1,52 @@
+#include "harness.h"
+#include <getopt.h>
+
+namespace bench
+{
+    namespace
+    {
+        struct getopt_state
+        {
+            std::vector<std::string> names;
+            std::vector<option> options;
+            std::vector<std::string> tokens;
+            std::vector<char*> argv;
+            std::vector<const char*> values;
+        };
+    }
+
+    std::function<std::size_t()>
+        getopt_long_baseline(std::size_t options, const std::vector<std::string_view>& line)
+    {
+        auto s = std::make_shared<getopt_state>();
+        s->names.reserve(options);
+        for (std::size_t i = 0; i < options; i++)
+        {
+            s->names.push_back(flat_name(i));
+            s->options.push_back({s->names.back().c_str(), i % 2 == 0 ? no_argument : required_argument, nullptr, 0});
+        }
+        s->options.push_back({nullptr, 0, nullptr, 0});
+        s->tokens.assign(line.begin(), line.end());
+        for (auto& token : s->tokens)
+        {
+            s->argv.push_back(token.data());
+        }
+        s->argv.push_back(nullptr);
+        s->values.resize(options);
+        return [s]
+            {
+                // optind = 0 makes glibc start over, "+" stops at the first non option instead of permuting argv
+                optind = 0;
+                opterr = 0;
+                int index = 0;
+                std::size_t found = 0;
+                std::fill(s->values.begin(), s->values.end(), nullptr);
+                while (getopt_long(int(s->argv.size() - 1), s->argv.data(), "+", s->options.data(), &index) == 0)
+                {
+                    s->values[index] = optarg != nullptr ? optarg : "";
+                    found++;
+                }
+                return found;
+            };
+    }
+}
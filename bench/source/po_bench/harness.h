@@ -0,0 +1,48 @@
+#pragma once
+
+#include <po.h>
+#include <functional>
+#include <memory>
+
+namespace bench
+{
+    // A schema and the command lines parsed with it, every line starts with the program name. storage keeps the
+    // options and strings of generated schemas alive
+    struct schema
+    {
+        std::string name;
+        po::detail::parser* parser = nullptr;
+        std::vector<std::vector<std::string_view>> lines;
+        bool dispatch = false;
+        std::shared_ptr<void> storage{};
+        // Number of options of a flat schema, 0 for the others
+        std::size_t flat_options = 0;
+    };
+
+    // Options of the flat schemas alternate between flags and arguments, the getopt_long baseline uses the same names
+    inline std::string
+        flat_name(std::size_t i)
+    {
+        return (i % 2 == 0 ? "flag-" : "opt-") + std::to_string(i);
+    }
+
+    schema
+        flat_schema(std::size_t options, std::size_t tokens);
+    schema
+        nested_groups_schema(std::size_t depth);
+    schema
+        after_chain_schema(std::size_t depth);
+    schema
+        pattern_schema(std::size_t families, std::size_t tokens);
+
+    schema
+        candump_schema();
+    schema
+        nmcli_schema();
+    schema
+        example_schema();
+
+    // One getopt_long pass over line for a flat schema of the given size, returns a checksum of what it found
+    std::function<std::size_t()>
+        getopt_long_baseline(std::size_t options, const std::vector<std::string_view>& line);
+}
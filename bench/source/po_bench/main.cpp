@@ -0,0 +1,161 @@
+#include "harness.h"
+#include <chrono>
+#include <iostream>
+
+// Measures parse, notify, help rendering, completion and sub program dispatch for generated schemas and the schemas
+// of the tests, and compares flat schemas with getopt_long: po_bench [name filter] [ms per measurement]
+PO_INIT_ALLOCATION_STATS
+
+struct timing
+{
+    double ns = 0;
+    double allocations = 0;
+};
+
+// Runs f once to build the lookup tables and grow the result, then doubles the iterations until a run takes at
+// least min_seconds
+template <class F>
+static timing
+    measure(double min_seconds, F&& f)
+{
+    f();
+    for (std::size_t n = 1;; n *= 2)
+    {
+        auto before = po::stats::thread_allocations().count;
+        auto start = std::chrono::steady_clock::now();
+        for (std::size_t i = 0; i < n; i++)
+        {
+            f();
+        }
+        std::chrono::duration<double> d = std::chrono::steady_clock::now() - start;
+        if (d.count() >= min_seconds || n >= (std::size_t(1) << 30))
+        {
+            return {d.count() * 1e9 / n, double(po::stats::thread_allocations().count - before) / n};
+        }
+    }
+}
+
+static void
+    check(const po::outcome& o, const bench::schema& s)
+{
+    if (!o)
+    {
+        throw std::runtime_error(s.name + ": " + o.error().message());
+    }
+}
+
+int main(int argc, const char** argv)
+{
+    std::string_view filter = argc > 1 ? argv[1] : "";
+    double min_seconds = (argc > 2 ? po::lexical_cast<double>(argv[2]) : 100.0) / 1e3;
+    std::size_t checksum = 0;
+
+    std::vector<bench::schema> schemas;
+    for (std::size_t options : {1, 10, 100, 1000, 10000})
+    {
+        schemas.push_back(bench::flat_schema(options, 64));
+    }
+    for (std::size_t depth : {4, 64})
+    {
+        schemas.push_back(bench::nested_groups_schema(depth));
+        schemas.push_back(bench::after_chain_schema(depth));
+    }
+    for (std::size_t families : {1, 16, 256})
+    {
+        schemas.push_back(bench::pattern_schema(families, 64));
+    }
+    schemas.push_back(bench::candump_schema());
+    schemas.push_back(bench::nmcli_schema());
+    schemas.push_back(bench::example_schema());
+
+    std::cout << std::left << std::setw(26) << "schema" << std::right << std::setw(8) << "tokens"
+        << std::setw(12) << "ns/token" << std::setw(14) << "allocs/parse" << std::setw(16) << "parse+notify ns"
+        << std::setw(10) << "help us" << std::setw(13) << "complete us" << std::setw(14) << "schema bytes" << std::setw(14) << "dispatch ns" << "\n";
+    std::vector<std::pair<const bench::schema*, double>> flat;
+    for (const auto& s : schemas)
+    {
+        if (s.name.find(filter) == std::string::npos)
+        {
+            continue;
+        }
+        auto result = s.parser->make_result();
+        std::size_t tokens = 0;
+        for (const auto& line : s.lines)
+        {
+            check(s.parser->try_parse(line, result), s);
+            tokens += line.size() - 1;
+        }
+        auto parse = measure(min_seconds, [&]
+            {
+                for (const auto& line : s.lines)
+                {
+                    checksum += s.parser->try_parse(line, result).has_value();
+                }
+            });
+        auto notify = measure(min_seconds, [&]
+            {
+                for (const auto& line : s.lines)
+                {
+                    s.parser->try_parse(line, result);
+                    checksum += !s.parser->try_notify(result);
+                }
+            });
+        std::string text;
+        auto help = measure(min_seconds, [&]
+            {
+                text.clear();
+                po::detail::helper::help_writer w(text, 80);
+                s.parser->get_main_group()->print_help(w, s.name);
+                checksum += text.size();
+            });
+        // Completes the last word of the first line, like a TAB at its end
+        std::vector<po::completion> candidates;
+        auto complete = measure(min_seconds, [&]
+            {
+                const auto& line = s.lines.front();
+                s.parser->complete(line, line.size() - 1, result, candidates);
+                checksum += candidates.size();
+            });
+        std::cout << std::left << std::setw(26) << s.name << std::right << std::setw(8) << tokens
+            << std::fixed << std::setprecision(1) << std::setw(12) << parse.ns / tokens
+            << std::setw(14) << parse.allocations << std::setw(16) << notify.ns
+            << std::setprecision(2) << std::setw(10) << help.ns / 1e3 << std::setw(13) << complete.ns / 1e3
+            << std::setw(14) << po::stats::schema_footprint(*s.parser).total();
+        if (s.dispatch)
+        {
+            // The sub programs of the example print what they got
+            s.parser->try_parse(s.lines.front(), result);
+            auto buffer = std::cout.rdbuf(nullptr);
+            auto dispatch = measure(min_seconds, [&]
+                {
+                    checksum += s.parser->execute_main(result).value_or(0);
+                });
+            std::cout.rdbuf(buffer);
+            std::cout << std::setprecision(1) << std::setw(14) << dispatch.ns;
+        }
+        std::cout << "\n";
+        if (s.flat_options != 0)
+        {
+            flat.emplace_back(&s, parse.ns / tokens);
+        }
+    }
+    if (!flat.empty())
+    {
+        std::cout << "\n" << std::left << std::setw(26) << "flat schema" << std::right << std::setw(12) << "po ns/token"
+            << std::setw(22) << "getopt_long ns/token" << std::setw(10) << "ratio" << "\n";
+    }
+    for (const auto& [s, ns] : flat)
+    {
+        const auto& line = s->lines.front();
+        auto baseline = bench::getopt_long_baseline(s->flat_options, line);
+        auto getopt = measure(min_seconds, [&]
+            {
+                checksum += baseline();
+            });
+        double getopt_ns = getopt.ns / (line.size() - 1);
+        std::cout << std::left << std::setw(26) << s->name << std::right << std::fixed << std::setprecision(1)
+            << std::setw(12) << ns << std::setw(22) << getopt_ns << std::setprecision(2) << std::setw(9) << getopt_ns / ns << "x\n";
+    }
+    std::cout << "checksum " << checksum << "\n";
+    return 0;
+}
@@ -0,0 +1,13 @@
+// The schema of test/source/nmcli.cpp, its main is renamed so it doesn't clash with the one of po_bench
+#include "harness.h"
+#include <iostream>
+#define main nmcli_main
+#include "../../../test/source/nmcli.cpp"
+#undef main
+
+bench::schema
+    bench::nmcli_schema()
+{
+    return {"nmcli", &parser, {{"nmcli", "connection", "up", "uuid", "1234-5678", "ifname", "wlan0"},
+        {"nmcli", "-t", "--wait=5", "connection", "down", "id", "eth0"}}, true};
+}
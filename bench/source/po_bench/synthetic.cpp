@@ -0,0 +1,124 @@
+#include "harness.h"
+#include <deque>
+
+namespace bench
+{
+    namespace
+    {
+        // Owns a generated schema, the options are created at runtime and register themselves like static ones
+        struct synthetic
+        {
+            po::detail::parser parser;
+            std::deque<std::string> strings;
+            std::vector<std::unique_ptr<po::detail::base_option>> options;
+
+            std::string_view
+                keep(std::string text)
+            {
+                return strings.emplace_back(std::move(text));
+            }
+            template <class Option, class... Args>
+            Option&
+                add(Args&&... args)
+            {
+                auto option = std::make_unique<Option>(std::forward<Args>(args)...);
+                auto& result = *option;
+                options.push_back(std::move(option));
+                return result;
+            }
+        };
+
+        schema
+            make_schema(std::string name, std::shared_ptr<synthetic> s, std::vector<std::string_view> line)
+        {
+            schema result;
+            result.name = std::move(name);
+            result.parser = &s->parser;
+            result.lines.push_back(std::move(line));
+            result.storage = std::move(s);
+            return result;
+        }
+    }
+
+    schema
+        flat_schema(std::size_t options, std::size_t tokens)
+    {
+        auto s = std::make_shared<synthetic>();
+        for (std::size_t i = 0; i < options; i++)
+        {
+            auto name = s->keep(flat_name(i));
+            if (i % 2 == 0)
+            {
+                s->add<po::flag>(po::ParentGroup(s->parser), po::LongName(name));
+            }
+            else
+            {
+                s->add<po::argument<std::string_view>>(po::ParentGroup(s->parser), po::LongName(name), po::Def<std::string_view>(""));
+            }
+        }
+        // Every option at most once, spread over the whole schema
+        std::vector<std::string_view> line{"flat"};
+        for (std::size_t k = 0; k < std::min(tokens, options); k++)
+        {
+            std::size_t i = k * 7919 % options;
+            line.push_back(s->keep("--" + flat_name(i) + (i % 2 == 0 ? "" : "=value-" + std::to_string(k))));
+        }
+        auto result = make_schema("flat " + std::to_string(options), std::move(s), std::move(line));
+        result.flat_options = options;
+        return result;
+    }
+
+    schema
+        nested_groups_schema(std::size_t depth)
+    {
+        auto s = std::make_shared<synthetic>();
+        po::detail::base_group* parent = s->parser.get_main_group();
+        std::vector<std::string_view> line{"nested"};
+        for (std::size_t i = 0; i < depth; i++)
+        {
+            auto name = s->keep("level-" + std::to_string(i));
+            auto& group = s->add<po::group>(po::ParentGroup(*parent), po::LongName(name));
+            s->add<po::flag>(po::ParentGroup(group), po::LongName("verbose"), po::ShortName('v'));
+            s->add<po::argument<int>>(po::ParentGroup(group), po::LongName("value"), po::Def<int>(0));
+            line.insert(line.end(), {name, "-v", s->keep("--value=" + std::to_string(i))});
+            parent = &group;
+        }
+        return make_schema("nested groups " + std::to_string(depth), std::move(s), std::move(line));
+    }
+
+    schema
+        after_chain_schema(std::size_t depth)
+    {
+        // Shaped like "nmcli connection up id <ID> ifname <ifname> ...": a group followed by a positional, then
+        // groups with a positional bound to them, each one after the previous
+        auto s = std::make_shared<synthetic>();
+        auto& up = s->add<po::group>(po::ParentGroup(s->parser), po::LongName("up"));
+        po::detail::base_group* previous = &s->add<po::positional_argument<>>(po::LongName("<id>"), po::After(up));
+        std::vector<std::string_view> line{"chain", "up", "id"};
+        for (std::size_t i = 0; i < depth; i++)
+        {
+            auto name = s->keep("step-" + std::to_string(i));
+            auto& group = s->add<po::group>(po::After(*previous), po::LongName(name));
+            previous = &s->add<po::positional_argument<>>(po::LongName(s->keep("<value-" + std::to_string(i) + ">")), po::BindTo(group));
+            line.insert(line.end(), {name, s->keep("value-" + std::to_string(i))});
+        }
+        return make_schema("After/BindTo chain " + std::to_string(depth), std::move(s), std::move(line));
+    }
+
+    schema
+        pattern_schema(std::size_t families, std::size_t tokens)
+    {
+        auto s = std::make_shared<synthetic>();
+        for (std::size_t i = 0; i < families; i++)
+        {
+            s->add<po::multi_pattern_argument<std::string_view, std::string_view>>(po::ParentGroup(s->parser)
+                , po::Pattern(s->keep("family-" + std::to_string(i) + "-*")), po::Min(0));
+        }
+        std::vector<std::string_view> line{"patterns"};
+        for (std::size_t k = 0; k < tokens; k++)
+        {
+            line.push_back(s->keep("--family-" + std::to_string(k * 7919 % families) + "-key-" + std::to_string(k) + "=value"));
+        }
+        return make_schema("Pattern families " + std::to_string(families), std::move(s), std::move(line));
+    }
+}
@@ -0,0 +1,81 @@
+#include <po.h>
+#include <chrono>
+#include <iostream>
+
+// Parses 1M positional arguments into the order preserving vector of multi_positional_argument and, for comparison,
+// into the std::set<std::string_view> positionals were stored in before
+static po::detail::parser vector_parser;
+static po::multi_positional_argument<> vector_files{po::ParentGroup(vector_parser), po::Min(0)};
+
+static std::set<std::string_view> set_storage;
+static po::detail::parser set_parser;
+static po::multi_positional_argument<> set_files{po::ParentGroup(set_parser), po::Min(0), po::OnArgument<>([](std::string_view file)
+    {
+        set_storage.insert(file);
+    })};
+
+static po::detail::parser typed_parser;
+static po::multi_positional_argument<std::uint32_t> typed_ids{po::ParentGroup(typed_parser), po::Min(0)};
+
+template <class F>
+static void
+    run(const char* title, std::size_t iterations, std::size_t count, F&& f)
+{
+    auto start = std::chrono::steady_clock::now();
+    for (std::size_t i = 0; i < iterations; i++)
+    {
+        f();
+    }
+    std::chrono::duration<double> d = std::chrono::steady_clock::now() - start;
+    std::cout << std::left << std::setw(40) << title
+        << std::right << std::setw(10) << std::fixed << std::setprecision(2) << d.count() * 1e3 / iterations << " ms"
+        << std::setw(10) << std::setprecision(1) << d.count() * 1e9 / iterations / count << " ns/arg\n";
+}
+
+int main(int argc, const char** argv)
+{
+    std::size_t count = argc > 1 ? po::lexical_cast<std::size_t>(argv[1]) : 1000000;
+    std::size_t iterations = argc > 2 ? po::lexical_cast<std::size_t>(argv[2]) : 5;
+    std::vector<std::string> storage;
+    std::vector<std::string_view> paths{"prog"};
+    std::vector<std::string_view> ids{"prog"};
+    storage.reserve(count * 2);
+    for (std::size_t i = 0; i < count; i++)
+    {
+        // Unordered like paths coming out of find, so the set has to do real work
+        storage.push_back("/data/batch/" + std::to_string((i * 7919) % count) + "/input.dat");
+        paths.push_back(storage.back());
+        storage.push_back(std::to_string(i * 2654435761u % 4294967291u));
+        ids.push_back(storage.back());
+    }
+    auto vector_result = vector_parser.make_result();
+    auto arena_result = vector_parser.make_arena_result(count * 64);
+    auto set_result = set_parser.make_result();
+    auto typed_result = typed_parser.make_result();
+    std::size_t checksum = 0;
+
+    std::cout << count << " positional arguments\n";
+    run("std::set<std::string_view> (before)", iterations, count, [&]
+        {
+            set_storage.clear();
+            set_parser.parse(paths, set_result);
+            checksum += set_storage.size();
+        });
+    run("multi_positional_argument<>", iterations, count, [&]
+        {
+            vector_parser.parse(paths, vector_result);
+            checksum += vector_result[vector_files].size();
+        });
+    run("multi_positional_argument<> (arena)", iterations, count, [&]
+        {
+            vector_parser.parse(paths, arena_result);
+            checksum += arena_result[vector_files].size();
+        });
+    run("multi_positional_argument<uint32_t>", iterations, count, [&]
+        {
+            typed_parser.parse(ids, typed_result);
+            checksum += typed_result[typed_ids].size();
+        });
+    std::cout << "checksum " << checksum << "\n";
+    return 0;
+}
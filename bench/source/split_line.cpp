@@ -0,0 +1,146 @@
+#include <po.h>
+#include <chrono>
+#include <iostream>
+
+// Splits and parses long, heavily quoted command lines, once with the in place splitter of po and once with an
+// ad hoc splitter building a std::vector<std::string> per line like front-ends usually do before calling the parser
+static po::detail::parser parser;
+static po::flag verbose{po::ParentGroup(parser), po::ShortName('v'), po::LongName("verbose")};
+static po::argument<std::string_view> name{po::ParentGroup(parser), po::ShortName('n'), po::LongName("name")};
+static po::multi_argument<std::string_view> label{po::ParentGroup(parser), po::ShortName('l'), po::LongName("label"), po::Min(0), po::Max(std::size_t(-1))};
+static po::multi_positional_argument files{po::ParentGroup(parser), po::Min(0)};
+
+static std::vector<std::string>
+    split_naive(std::string_view line)
+{
+    std::vector<std::string> result;
+    std::string word;
+    bool in_word = false;
+    char quote = 0;
+    for (std::size_t i = 0; i < line.size(); i++)
+    {
+        char c = line[i];
+        if (quote != 0)
+        {
+            if (c == quote)
+            {
+                quote = 0;
+            }
+            else if (quote == '"' && c == '\\' && i + 1 < line.size())
+            {
+                word.push_back(line[++i]);
+            }
+            else
+            {
+                word.push_back(c);
+            }
+        }
+        else if (c == ' ' || c == '\t')
+        {
+            if (in_word)
+            {
+                result.push_back(word);
+                word.clear();
+                in_word = false;
+            }
+        }
+        else
+        {
+            in_word = true;
+            if (c == '\'' || c == '"')
+            {
+                quote = c;
+            }
+            else if (c == '\\' && i + 1 < line.size())
+            {
+                word.push_back(line[++i]);
+            }
+            else
+            {
+                word.push_back(c);
+            }
+        }
+    }
+    if (in_word)
+    {
+        result.push_back(word);
+    }
+    return result;
+}
+
+static std::string
+    make_line(std::size_t words)
+{
+    std::string result = "prog -v";
+    for (std::size_t i = 0; i < words; i++)
+    {
+        switch (i % 5)
+        {
+        case 0:
+            result += " --label=\"a label with \\\"escaped\\\" quotes and spaces " + std::to_string(i) + "\"";
+            break;
+        case 1:
+            result += " -l 'single quoted $text with \\ backslashes " + std::to_string(i) + "'";
+            break;
+        case 2:
+            result += " --name \"mixed\"'quoting'\\ and\\ escapes" + std::to_string(i);
+            break;
+        case 3:
+            result += " file_with_a_rather_long_unquoted_name_" + std::to_string(i) + ".txt";
+            break;
+        default:
+            result += " \"/path/with spaces/to/file " + std::to_string(i) + ".txt\"";
+            break;
+        }
+    }
+    return result;
+}
+
+template <class F>
+static void
+    run(const char* title, std::size_t iterations, std::size_t bytes, F&& f)
+{
+    auto start = std::chrono::steady_clock::now();
+    for (std::size_t i = 0; i < iterations; i++)
+    {
+        f();
+    }
+    std::chrono::duration<double> d = std::chrono::steady_clock::now() - start;
+    std::cout << std::left << std::setw(34) << title
+        << std::right << std::setw(10) << std::fixed << std::setprecision(1) << d.count() * 1e9 / iterations << " ns/line"
+        << std::setw(10) << std::setprecision(1) << bytes * iterations / d.count() / 1e6 << " MB/s\n";
+}
+
+int main(int argc, const char** argv)
+{
+    std::size_t words = argc > 1 ? po::lexical_cast<std::size_t>(argv[1]) : 200;
+    std::size_t iterations = argc > 2 ? po::lexical_cast<std::size_t>(argv[2]) : 20000;
+    auto line = make_line(words);
+    auto result = parser.make_arena_result(1 << 20);
+    std::size_t checksum = 0;
+
+    std::cout << "line: " << line.size() << " bytes, " << words << " quoted words\n";
+    run("split in place", iterations, line.size(), [&]
+        {
+            result.input().assign(line);
+            checksum += po::detail::split_command_line(result.input().data(), result.input().size());
+        });
+    run("split vector<string>", iterations, line.size(), [&]
+        {
+            checksum += split_naive(line).size();
+        });
+    run("parse_line (in place, arena)", iterations, line.size(), [&]
+        {
+            parser.parse_line(line, result);
+            checksum += result[label].size();
+        });
+    run("vector<string> + parse(span)", iterations, line.size(), [&]
+        {
+            auto words_ = split_naive(line);
+            std::vector<std::string_view> args(words_.begin(), words_.end());
+            parser.parse(args, result);
+            checksum += result[label].size();
+        });
+    std::cout << "checksum " << checksum << "\n";
+    return 0;
+}
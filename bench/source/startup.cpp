@@ -0,0 +1,82 @@
+#include <po.h>
+#include <chrono>
+#include <iostream>
+#include <spawn.h>
+#include <sys/wait.h>
+
+// Counts the heap allocations done while the static options of an nmcli sized command line are constructed and
+// measures how long it takes to start the program: startup --spawn 1000
+PO_INIT_ALLOCATION_STATS
+
+static std::size_t
+    allocations()
+{
+    return po::stats::thread_allocations().count;
+}
+
+static po::detail::parser parser;
+static po::help help{po::ParentGroup(parser), po::Header("Usage: nmcli [OPTIONS] OBJECT { COMMAND | help }")
+    , po::Message("OBJECT is one of general, networking, radio, connection, device, agent, monitor or ip, "
+        "and every OBJECT has its own --help")};
+static po::flag ask{po::ParentGroup(parser), po::LongName("ask"), po::ShortName('a')};
+static po::argument<std::string> colors{po::ParentGroup(parser), po::LongName("colors"), po::ShortName('c'), po::Def<std::string>("auto")};
+static po::argument<std::string> mode{po::ParentGroup(parser), po::LongName("mode"), po::ShortName('m'), po::Def<std::string>("tabular")};
+static po::optional_argument<std::size_t> wait_seconds{po::ParentGroup(parser), po::LongName("wait"), po::ShortName('w')};
+static po::multi_pattern_argument<std::string_view, std::string_view> defines{po::ParentGroup(parser), po::Pattern("define-*"), po::Min(0)};
+
+template <std::size_t Group>
+struct sub_command
+{
+    static inline po::group group{po::ParentGroup(parser), po::LongName(std::array{"general", "networking", "radio", "connection", "device", "agent", "monitor", "ip"}[Group])};
+    static inline po::flag active{po::ParentGroup(group), po::LongName("active")};
+    static inline po::flag terse{po::ParentGroup(group), po::LongName("terse"), po::ShortName('t')};
+    static inline po::argument<std::string_view> id{po::ParentGroup(group), po::LongName("id"), po::Def<std::string_view>("")};
+    static inline po::argument<std::uint32_t> timeout{po::ParentGroup(group), po::LongName("timeout"), po::Def<std::uint32_t>(90)};
+    static inline po::multi_argument<std::string_view> fields{po::ParentGroup(group), po::LongName("fields"), po::ShortName('f'), po::Min(0), po::Max(16)};
+    static inline po::flag show_secrets{po::ParentGroup(group), po::LongName("show-secrets"), po::ShortName('s')};
+    static inline po::group show{po::ParentGroup(group), po::LongName("show")};
+    static inline po::flag show_active{po::ParentGroup(show), po::LongName("active")};
+    static inline po::positional_argument<> show_id{po::ParentGroup(show)};
+};
+template struct sub_command<0>;
+template struct sub_command<1>;
+template struct sub_command<2>;
+template struct sub_command<3>;
+template struct sub_command<4>;
+template struct sub_command<5>;
+template struct sub_command<6>;
+template struct sub_command<7>;
+
+static std::size_t allocations_before_main = allocations();
+
+int main(int argc, const char** argv)
+{
+    std::size_t before_main = allocations();
+    if (argc > 1 && std::string_view(argv[1]) == "--exit")
+    {
+        return before_main == 0 ? 0 : 1;
+    }
+    std::cout << "heap allocations before main: " << before_main << " (" << allocations_before_main << " at the end of this file)\n";
+    if (argc > 2 && std::string_view(argv[1]) == "--spawn")
+    {
+        std::size_t count = po::lexical_cast<std::size_t>(argv[2]);
+        char exit_arg[] = "--exit";
+        char* args[] = {const_cast<char*>(argv[0]), exit_arg, nullptr};
+        auto start = std::chrono::steady_clock::now();
+        for (std::size_t i = 0; i < count; i++)
+        {
+            pid_t pid;
+            int status = 0;
+            if (posix_spawn(&pid, argv[0], nullptr, nullptr, args, environ) != 0 || waitpid(pid, &status, 0) != pid)
+            {
+                std::cerr << "spawn failed\n";
+                return 1;
+            }
+        }
+        std::chrono::duration<double> d = std::chrono::steady_clock::now() - start;
+        std::cout << "spawn and exit: " << std::fixed << std::setprecision(1) << d.count() * 1e6 / count << " us\n";
+    }
+    parser.parse_command_line(std::vector<std::string_view>{argv[0], "--ask", "connection", "--id=eth0"});
+    std::cout << "allocations after the first parse: " << allocations() - before_main << "\n";
+    return 0;
+}
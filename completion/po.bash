@@ -0,0 +1,14 @@
+# Bash completion for programs using po. They answer "program --complete-args <words> <word at the cursor>" with
+# one candidate per line. Source this file and register every program:
+#   source po.bash
+#   complete -o default -F _po_complete nmcli
+# Without candidates (e.g. for a positional) bash falls back to file names.
+_po_complete()
+{
+    local IFS=$'\n'
+    COMPREPLY=($("${COMP_WORDS[0]}" --complete-args "${COMP_WORDS[@]:1:COMP_CWORD}" 2>/dev/null))
+    # The prefix of a pattern like --define- is only the start of the word
+    if [[ ${#COMPREPLY[@]} -eq 1 && ${COMPREPLY[0]} == *[-=] ]]; then
+        compopt -o nospace 2>/dev/null
+    fi
+}
@@ -2,6 +2,7 @@
 #pragma once
 
 #include <cstring>
+#include <cstdio>
 #include <utility>
 #include <vector>
 #include <memory>
@@ -16,34 +17,624 @@
 #include <ostream>
 #include <iomanip>
 #include <filesystem>
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <stdexcept>
+#include <span>
+#include <bit>
+#include <charconv>
+#include <system_error>
+#include <cerrno>
+#include <cstdlib>
+#include <cctype>
+#include <mutex>
+#include <memory_resource>
+#include <fstream>
+#include <thread>
+#include <atomic>
+#include <condition_variable>
+#include <new>
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+#endif
 
 namespace po
 {
     enum class ParseStatus
     {
-        NoMatch, Match, HelpParsed
+        NoMatch, Match, HelpParsed, Error
     };
+    enum class ErrorCode
+    {
+        None, UnknownArgument, MissingValue, InvalidValue, OutOfRange, MissingClosingQuote, ResponseFileOpen,
+        ResponseFileMap, ResponseFileLoop, MissingGroup, MissingBound, MissingAfter, TooFewArguments,
+        TooManyArguments, FlagRepeated, FlagTooFew, FlagTooMany, TooFewPositionals, TooManyPositionals
+    };
+
+    // What went wrong in a parse, notify or validate, filled in without allocating. The views point into the
+    // parse_result or the option objects, so an error is valid as long as they are, the text is only formatted
+    // by message
+    class error
+    {
+    public:
+        static constexpr std::size_t npos = std::size_t(-1);
+
+        error() = default;
+        error(ErrorCode code, std::size_t token, std::string_view name, std::string_view text = {}, std::size_t limit = 0)
+            : _code(code)
+            , _token(token)
+            , _name(name)
+            , _text(text)
+            , _limit(limit)
+        {}
+        // Error of a value of option name that didn't convert
+        static error
+            conversion(std::errc ec, std::size_t token, std::string_view text, std::string_view name = {})
+        {
+            return error(ec == std::errc::result_out_of_range ? ErrorCode::OutOfRange : ErrorCode::InvalidValue,
+                token, name, text);
+        }
+        // Error naming a file, which is the only case where the error owns its text
+        static error
+            file(ErrorCode code, std::string path)
+        {
+            error result(code, npos, {});
+            result._path = std::move(path);
+            return result;
+        }
+        explicit operator bool() const
+        {
+            return _code != ErrorCode::None;
+        }
+        ErrorCode
+            code() const
+        {
+            return _code;
+        }
+        // Index of the offending token among the arguments after the program name, npos if the error isn't
+        // caused by a single token
+        std::size_t
+            token() const
+        {
+            return _token;
+        }
+        // Option the error is about
+        std::string_view
+            name() const
+        {
+            return _name;
+        }
+        // Offending text, or the name of the second option of MissingBound
+        std::string_view
+            text() const
+        {
+            return _text;
+        }
+        std::string
+            message() const
+        {
+            std::string name(_name);
+            std::string text(_text);
+            switch (_code)
+            {
+            case ErrorCode::None:
+                break;
+            case ErrorCode::UnknownArgument:
+                return "po error: unkown argument \"" + text + "\"";
+            case ErrorCode::MissingValue:
+                return "po error: missing value for \"" + name + "\"";
+            case ErrorCode::InvalidValue:
+                return "po error: invalid value \"" + text + "\"";
+            case ErrorCode::OutOfRange:
+                return "po error: value \"" + text + "\" is out of range";
+            case ErrorCode::MissingClosingQuote:
+                return "po error: missing closing " + text + " in command line";
+            case ErrorCode::ResponseFileOpen:
+                return "po error: could not open response file \"" + _path + "\"";
+            case ErrorCode::ResponseFileMap:
+                return "po error: could not map response file \"" + _path + "\"";
+            case ErrorCode::ResponseFileLoop:
+                return "po error: response file \"" + _path + "\" includes itself";
+            case ErrorCode::MissingGroup:
+                return "po error: could not find option \"" + name + "\"";
+            case ErrorCode::MissingBound:
+                return "po error: if \"" + name + "\" is given, \"" + text + "\" must follow";
+            case ErrorCode::MissingAfter:
+                return "po error: could not find \"" + name + "\"";
+            case ErrorCode::TooFewArguments:
+                return "po error: too less \"" + name + "\" arguments given (min=" + std::to_string(_limit) + ")";
+            case ErrorCode::TooManyArguments:
+                return "po error: too many \"" + name + "\" arguments given (max=" + std::to_string(_limit) + ")";
+            case ErrorCode::FlagRepeated:
+                return "po error: flag \"" + name + "\" is specified more than once";
+            case ErrorCode::FlagTooFew:
+                return "po error: flag \"" + name + "\" appeared too less (min=" + std::to_string(_limit) + ")";
+            case ErrorCode::FlagTooMany:
+                return "po error: flag \"" + name + "\" appeared too often (max=" + std::to_string(_limit) + ")";
+            case ErrorCode::TooFewPositionals:
+                return "po error: too less arguments for positional arguments (min=" + std::to_string(_limit) + ")";
+            case ErrorCode::TooManyPositionals:
+                return "po error: too many arguments for \"" + name + "\" (max=" + std::to_string(_limit) + ")";
+            }
+            return std::string();
+        }
+
+    private:
+        ErrorCode _code{ErrorCode::None};
+        std::size_t _token{npos};
+        std::string_view _name;
+        std::string_view _text;
+        std::size_t _limit{0};
+        std::string _path;
+    };
+    // Result of the parse functions that don't throw, like std::expected<ParseStatus, error>. A parse that
+    // stopped at a help option has the status HelpParsed and no error
+    class outcome
+    {
+    public:
+        outcome(ParseStatus status)
+            : _status(status)
+        {}
+        outcome(po::error error)
+            : _status(ParseStatus::Error)
+            , _error(std::move(error))
+        {}
+        bool
+            has_value() const
+        {
+            return _status != ParseStatus::Error;
+        }
+        explicit operator bool() const
+        {
+            return has_value();
+        }
+        ParseStatus
+            status() const
+        {
+            return _status;
+        }
+        const po::error&
+            error() const
+        {
+            return _error;
+        }
+
+    private:
+        ParseStatus _status;
+        po::error _error;
+    };
+    class help_ex
+        : public std::runtime_error
+    {
+    public:
+        using std::runtime_error::runtime_error;
+
+        // Writes the help text to stdout at once
+        void
+            print() const
+        {
+            std::string_view text(what());
+            std::fflush(stdout);
+#if defined(__unix__) || defined(__APPLE__)
+            while (!text.empty())
+            {
+                auto written = ::write(STDOUT_FILENO, text.data(), text.size());
+                if (written < 0 && errno != EINTR)
+                {
+                    break;
+                }
+                text.remove_prefix(written > 0 ? static_cast<std::size_t>(written) : 0);
+            }
+#else
+            std::fwrite(text.data(), 1, text.size(), stdout);
+            std::fflush(stdout);
+#endif
+        }
+    };
+
+    namespace detail
+    {
+        class base_option;
+        class base_group;
+#if defined(PO_TRACE)
+        inline constexpr bool trace_enabled = true;
+#else
+        inline constexpr bool trace_enabled = false;
+#endif
+    }
+    enum class TraceKind : std::uint8_t
+    {
+        Begin, Lookup, Parsed, Follow, End
+    };
+    // One step of a parse. token is the index of the token among the arguments after the program name, at End the
+    // number of tokens consumed. option is the candidate a Lookup found (nullptr if none), the option or group
+    // that was Parsed or the option a Follow (After, BindTo, positionals) continues with. comparisons counts the
+    // names and patterns a Lookup compared the token with, depth is the number of states on the parse stack
+    // below a Follow
+    struct trace_event
+    {
+        TraceKind kind;
+        std::size_t token{0};
+        const detail::base_option* option{nullptr};
+        ParseStatus status{ParseStatus::NoMatch};
+        std::size_t comparisons{0};
+        std::size_t depth{0};
+    };
+    // Receives the events of the parses into a parse_result it is set on. Events are only sent if every
+    // translation unit is compiled with PO_TRACE defined, without it the hooks compile to nothing
+    class trace_sink
+    {
+    public:
+        virtual ~trace_sink() = default;
+        virtual void
+            event(const trace_event& e) = 0;
+    };
+    // Sums up every parse and prints the totals when it ends
+    class trace_totals
+        : public trace_sink
+    {
+    public:
+        struct totals
+        {
+            std::size_t tokens{0};
+            std::size_t lookups{0};
+            std::size_t comparisons{0};
+            std::size_t parsed{0};
+            std::size_t depth{0};
+        };
+
+        trace_totals(std::ostream& out)
+            : _out(out)
+        {}
+        virtual void
+            event(const trace_event& e) override
+        {
+            switch (e.kind)
+            {
+            case TraceKind::Begin:
+                _totals = totals{};
+                break;
+            case TraceKind::Lookup:
+                _totals.lookups++;
+                _totals.comparisons += e.comparisons;
+                break;
+            case TraceKind::Parsed:
+                _totals.parsed++;
+                break;
+            case TraceKind::Follow:
+                _totals.depth = std::max(_totals.depth, e.depth);
+                break;
+            case TraceKind::End:
+                _totals.tokens = e.token;
+                _out << "po trace: " << _totals.tokens << " tokens, " << _totals.lookups << " lookups, "
+                    << _totals.comparisons << " comparisons, " << _totals.parsed << " parsed, follower depth "
+                    << _totals.depth << "\n";
+                break;
+            }
+        }
+        // Totals of the last parse
+        const totals&
+            last() const
+        {
+            return _totals;
+        }
+
+    private:
+        std::ostream& _out;
+        totals _totals;
+    };
+    // A token two options or groups of group compete for, taken is the one declared first, shadowed the one that
+    // couldn't be reached with it. A parser with fatal conflicts throws on every parse, see parser::conflicts. A long
+    // name a pattern matches as well isn't fatal, the exact name takes the token and the pattern all others
+    struct conflict
+    {
+        const detail::base_group* group;
+        std::string token;
+        const detail::base_option* taken;
+        const detail::base_option* shadowed;
+        bool fatal{true};
+    };
+    enum class CompletionKind : std::uint8_t
+    {
+        Option, Group, Pattern, Positional
+    };
+    // A candidate for the word being completed, see parser::complete. text replaces the word: --long or -s for an
+    // option, the part before the first '*' for a Pattern and the name for a Positional, which takes any word
+    struct completion
+    {
+        CompletionKind kind;
+        std::string text;
+        const detail::base_option* option;
+    };
+
     namespace detail
     {
         namespace helper
         {
             template <class T>
-            constexpr T lexical_cast(const std::string_view sv)
+            inline constexpr bool dependent_false_v = false;
+
+            // Strict std::from_chars wrapper, the whole input has to be consumed
+            template <class T>
+            std::errc from_chars(std::string_view sv, T& value, int base = 10)
+            {
+                if (sv.size() > 1 && sv[0] == '+' && sv[1] != '-')
+                {
+                    sv.remove_prefix(1);
+                }
+                std::from_chars_result result;
+                if constexpr (std::is_integral_v<T>)
+                {
+                    result = std::from_chars(sv.data(), sv.data() + sv.size(), value, base);
+                }
+                else
+                {
+#if defined(__cpp_lib_to_chars)
+                    result = std::from_chars(sv.data(), sv.data() + sv.size(), value);
+#else
+                    // No floating point std::from_chars before libstdc++ 11
+                    std::string str(sv);
+                    char* end = nullptr;
+                    errno = 0;
+                    if constexpr (std::is_same_v<T, float>)
+                    {
+                        value = std::strtof(str.c_str(), &end);
+                    }
+                    else if constexpr (std::is_same_v<T, double>)
+                    {
+                        value = std::strtod(str.c_str(), &end);
+                    }
+                    else
+                    {
+                        value = std::strtold(str.c_str(), &end);
+                    }
+                    result.ptr = sv.data() + (end - str.c_str());
+                    result.ec = errno == ERANGE ? std::errc::result_out_of_range : std::errc{};
+                    if (end == str.c_str() || std::isspace(static_cast<unsigned char>(str[0])))
+                    {
+                        result.ec = std::errc::invalid_argument;
+                    }
+#endif
+                }
+                if (result.ec == std::errc{} && result.ptr != sv.data() + sv.size())
+                {
+                    result.ec = std::errc::invalid_argument;
+                }
+                return result.ec;
+            }
+        }
+    }
+
+    // Customization point for converting command line values, specialize po::converter<T> for own types
+    template <class T, class Enable = void>
+    struct converter
+    {
+        static std::errc
+            from_string(std::string_view sv, T& value)
+        {
+            std::errc result{};
+            if constexpr (std::is_same_v<T, bool>)
             {
-                T result;
-                if constexpr (std::is_arithmetic_v<T>)
+                if (sv == "1" || sv == "true")
+                {
+                    value = true;
+                }
+                else if (sv == "0" || sv == "false")
                 {
-                    std::istringstream ss;
-                    ss.str(std::string(sv));
-                    ss >> result;
+                    value = false;
                 }
                 else
                 {
-                    result = static_cast<T>(sv);
+                    result = std::errc::invalid_argument;
+                }
+            }
+            else if constexpr (std::is_same_v<T, char>)
+            {
+                value = sv.size() == 1 ? sv[0] : value;
+                result = sv.size() == 1 ? std::errc{} : std::errc::invalid_argument;
+            }
+            else if constexpr (std::is_arithmetic_v<T>)
+            {
+                result = detail::helper::from_chars(sv, value);
+            }
+            else if constexpr (std::is_constructible_v<T, std::string_view>)
+            {
+                value = static_cast<T>(sv);
+            }
+            else
+            {
+                static_assert(detail::helper::dependent_false_v<T>, "po error static_assert: no po::converter for type");
+            }
+            return result;
+        }
+    };
+
+    // Integral value given in base Base, hex/oct/bin values may carry their 0x/0/0b prefix
+    template <class T, int Base>
+    class radix
+    {
+    public:
+        using value_type = T;
+
+        constexpr radix(T value = T{})
+            : _value(value)
+        {}
+        constexpr operator T() const
+        {
+            return _value;
+        }
+        friend std::ostream&
+            operator<<(std::ostream& os, const radix& r)
+        {
+            char digits[sizeof(T) * 8 + 1];
+            auto end = std::to_chars(digits, digits + sizeof(digits), +r._value, Base).ptr;
+            return os << (Base == 16 ? "0x" : (Base == 2 ? "0b" : (Base == 8 ? "0" : "")))
+                << std::string_view(digits, std::size_t(end - digits));
+        }
+
+    private:
+        T _value;
+    };
+    template <class T>
+    using hex = radix<T, 16>;
+    template <class T>
+    using oct = radix<T, 8>;
+    template <class T>
+    using bin = radix<T, 2>;
+
+    template <class T, int Base>
+    struct converter<radix<T, Base>>
+    {
+        static std::errc
+            from_string(std::string_view sv, radix<T, Base>& value)
+        {
+            if (sv.size() > 2 && sv[0] == '0' && ((Base == 16 && (sv[1] == 'x' || sv[1] == 'X')) ||
+                (Base == 2 && (sv[1] == 'b' || sv[1] == 'B'))))
+            {
+                sv.remove_prefix(2);
+            }
+            T result{};
+            auto ec = detail::helper::from_chars(sv, result, Base);
+            if (ec == std::errc{})
+            {
+                value = result;
+            }
+            return ec;
+        }
+    };
+
+    namespace detail
+    {
+        namespace helper
+        {
+            // String literal usable as template argument
+            template <std::size_t N>
+            struct fixed_string
+            {
+                constexpr fixed_string(const char (&str)[N])
+                {
+                    for (std::size_t i = 0; i < N; i++)
+                    {
+                        data[i] = str[i];
+                    }
+                }
+                constexpr std::string_view
+                    view() const
+                {
+                    return std::string_view(data, N - 1);
+                }
+
+                char data[N]{};
+            };
+            // Heap memory held by a string, none while it fits into its small buffer
+            inline std::size_t
+                heap_size(const std::string& s)
+            {
+                auto* object = reinterpret_cast<const char*>(&s);
+                bool local = !std::less<const char*>()(s.data(), object) && std::less<const char*>()(s.data(), object + sizeof(s));
+                return local ? 0 : s.capacity() + 1;
+            }
+
+            template <class T>
+            T lexical_cast(const std::string_view sv)
+            {
+                T result{};
+                auto ec = converter<T>::from_string(sv, result);
+                if (ec != std::errc{})
+                {
+                    throw std::runtime_error(error::conversion(ec, error::npos, sv).message());
                 }
                 return result;
             }
 
+            // Type a value of T is stored as inside a parse_result, strings allocate from the memory resource
+            // of the result
+            template <class T>
+            struct result_type
+            {
+                using type = T;
+            };
+            template <>
+            struct result_type<std::string>
+            {
+                using type = std::pmr::string;
+            };
+            template <class T>
+            using result_type_t = typename result_type<T>::type;
+
+            template <class T>
+            result_type_t<T> lexical_cast(const std::string_view sv, std::pmr::memory_resource* mr)
+            {
+                if constexpr (std::is_same_v<result_type_t<T>, T>)
+                {
+                    return lexical_cast<T>(sv);
+                }
+                else
+                {
+                    return result_type_t<T>(sv, mr);
+                }
+            }
+            // Same as lexical_cast but reports a failed conversion instead of throwing, result is only set on success
+            template <class T>
+            std::errc try_lexical_cast(const std::string_view sv, std::optional<result_type_t<T>>& result, std::pmr::memory_resource* mr)
+            {
+                std::errc ec{};
+                if constexpr (std::is_same_v<result_type_t<T>, T>)
+                {
+                    T value{};
+                    ec = converter<T>::from_string(sv, value);
+                    if (ec == std::errc{})
+                    {
+                        result.emplace(std::move(value));
+                    }
+                }
+                else
+                {
+                    result.emplace(sv, mr);
+                }
+                return ec;
+            }
+            // Copies a value stored inside a parse_result into the type the classic api returns
+            template <class T, class R>
+            decltype(auto) to_type(const R& r)
+            {
+                if constexpr (std::is_same_v<T, R>)
+                {
+                    return (r);
+                }
+                else if constexpr (std::is_same_v<T, std::string>)
+                {
+                    return T(r);
+                }
+                else if constexpr (requires { typename T::mapped_type; })
+                {
+                    T result;
+                    for (const auto& [k, v] : r)
+                    {
+                        result.emplace(to_type<typename T::key_type>(k), to_type<typename T::mapped_type>(v));
+                    }
+                    return result;
+                }
+                else if constexpr (requires { typename T::value_type; r.has_value(); })
+                {
+                    return r ? T(to_type<typename T::value_type>(*r)) : T();
+                }
+                else
+                {
+                    T result;
+                    for (const auto& e : r)
+                    {
+                        result.insert(result.end(), to_type<typename T::value_type>(e));
+                    }
+                    return result;
+                }
+            }
+
             template <class T, class Tag_t>
             class named_type
             {
@@ -84,801 +675,4077 @@ namespace po
                 return def;
             }
             
-            void print_1_column(std::ostream& os, std::string_view text)
+            // Width of the terminal on stdout, COLUMNS or 80 if stdout is no terminal. Queried once
+            inline std::size_t
+                terminal_width()
             {
+                static const std::size_t width = []
+                {
+                    std::size_t result = 0;
+#if defined(__unix__) || defined(__APPLE__)
+                    winsize ws{};
+                    if (::isatty(STDOUT_FILENO) && ::ioctl(STDOUT_FILENO, TIOCGWINSZ, &ws) == 0)
+                    {
+                        result = ws.ws_col;
+                    }
+#endif
+                    const char* columns = std::getenv("COLUMNS");
+                    if (result == 0 && columns != nullptr)
+                    {
+                        std::from_chars(columns, columns + std::strlen(columns), result);
+                    }
+                    return result != 0 ? result : 80;
+                }();
+                return width;
             }
-            void print_2_columns(std::ostream& os, std::string_view left, std::string_view right)
+            // Renders help text into one buffer. An entry is a name, padded to the description column, followed by
+            // its description wrapped at the width of the terminal
+            class help_writer
             {
-                os << "  ";
-                os << std::setw(26) << std::left << left;
-                if (left.size() > 22 && right != "")
+            public:
+                static constexpr std::size_t indent = 2;
+                static constexpr std::size_t name_width = 26;
+                static constexpr std::size_t min_desc_width = 20;
+
+                help_writer(std::string& out, std::size_t width)
+                    : _out(out)
+                    , _width(width)
+                {}
+                help_writer&
+                    operator<<(std::string_view text)
+                {
+                    _out.append(text);
+                    return *this;
+                }
+                help_writer&
+                    operator<<(char c)
+                {
+                    _out.push_back(c);
+                    return *this;
+                }
+                template <class T>
+                    requires std::is_arithmetic_v<T>
+                help_writer&
+                    operator<<(T value)
+                {
+                    std::array<char, 64> buffer;
+                    char* end = buffer.data();
+                    if constexpr (std::is_same_v<T, bool>)
+                    {
+                        *end++ = value ? '1' : '0';
+                    }
+#if !defined(__cpp_lib_to_chars)
+                    else if constexpr (std::is_floating_point_v<T>)
+                    {
+                        end += std::snprintf(buffer.data(), buffer.size(), "%Lg", static_cast<long double>(value));
+                    }
+#endif
+                    else
+                    {
+                        end = std::to_chars(buffer.data(), buffer.data() + buffer.size(), value).ptr;
+                    }
+                    _out.append(buffer.data(), end);
+                    return *this;
+                }
+                // The name of the entry is written next
+                void
+                    begin_entry()
                 {
-                    os << "\n  " << std::setw(26) << "";
+                    _out.append(indent, ' ');
+                    _entry = _out.size();
                 }
-                std::stringstream desc_{std::string(right)};
-                std::size_t bytes_written = 0;
-                std::string line;
-                while (std::getline(desc_, line, '\n'))
+                void
+                    end_entry(std::string_view desc)
                 {
-                    std::stringstream line_{line};
-                    while (line_)
+                    std::size_t column = indent + name_width;
+                    std::size_t name_size = _out.size() - _entry;
+                    if (!desc.empty())
                     {
-                        std::string word;
-                        line_ >> word;
-                        if (bytes_written > 0 && bytes_written + word.size() > 32)
+                        if (name_size + 4 > name_width)
                         {
-                            bytes_written = 0;
-                            os << "\n  " << std::setw(26) << "";
+                            _out.push_back('\n');
+                            _out.append(column, ' ');
                         }
-                        if (word == "")
+                        else
                         {
-                            break;
+                            _out.append(name_width - name_size, ' ');
+                        }
+                    }
+                    std::size_t desc_width = std::max(min_desc_width, _width > column ? _width - column : 0);
+                    std::size_t used = 0;
+                    std::size_t pos = 0;
+                    while (pos < desc.size())
+                    {
+                        char c = desc[pos];
+                        if (c == '\n')
+                        {
+                            _out.push_back('\n');
+                            _out.append(column, ' ');
+                            used = 0;
+                            pos++;
+                        }
+                        else if (c == ' ' || c == '\t')
+                        {
+                            pos++;
+                        }
+                        else
+                        {
+                            std::size_t end = desc.find_first_of(" \t\n", pos);
+                            end = end == std::string_view::npos ? desc.size() : end;
+                            if (used > 0 && used + 1 + (end - pos) > desc_width)
+                            {
+                                _out.push_back('\n');
+                                _out.append(column, ' ');
+                                used = 0;
+                            }
+                            else if (used > 0)
+                            {
+                                _out.push_back(' ');
+                                used++;
+                            }
+                            _out.append(desc.substr(pos, end - pos));
+                            used += end - pos;
+                            pos = end;
                         }
-                        os << word << " ";
-                        bytes_written += word.size() + 1;
                     }
-                    bytes_written = 0;
-                    os << "\n  " << std::setw(26) << "";
+                    _out.append("\n\n");
                 }
-            }
-        }
-        class base_sub_program
+
+            private:
+                std::string& _out;
+                std::size_t _width;
+                std::size_t _entry{0};
+            };
+        }
+        enum class TokenKind : std::uint8_t
+        {
+            ShortCluster, Long, LongWithValue, Word, Terminator
+        };
+        // A command line argument classified once by parser::parse_command_line, options and groups only look at
+        // the precomputed spans instead of inspecting the raw argument again
+        struct token
+        {
+            const char* data{nullptr};
+            std::uint32_t size{0};
+            std::uint32_t name_size{0};
+            TokenKind kind{TokenKind::Word};
+
+            static token
+                classify(const char* arg)
+            {
+                token result;
+                result.data = arg;
+                if (arg[0] == '-' && arg[1] == '-')
+                {
+                    const char* end = arg + 2;
+                    const char* eq = nullptr;
+                    for (; *end != 0; end++)
+                    {
+                        eq = eq == nullptr && *end == '=' ? end : eq;
+                    }
+                    result.size = static_cast<std::uint32_t>(end - arg);
+                    result.name_size = static_cast<std::uint32_t>((eq != nullptr ? eq : end) - arg - 2);
+                    result.kind = result.size == 2 ? TokenKind::Terminator :
+                        (eq != nullptr ? TokenKind::LongWithValue : TokenKind::Long);
+                }
+                else
+                {
+                    const char* end = arg;
+                    while (*end != 0)
+                    {
+                        end++;
+                    }
+                    result.size = static_cast<std::uint32_t>(end - arg);
+                    result.kind = arg[0] == '-' && arg[1] != 0 ? TokenKind::ShortCluster : TokenKind::Word;
+                    result.name_size = result.kind == TokenKind::ShortCluster ? result.size - 1 : result.size;
+                }
+                return result;
+            }
+            static token
+                classify(std::string_view arg)
+            {
+                token result;
+                result.data = arg.data();
+                result.size = static_cast<std::uint32_t>(arg.size());
+                if (arg.size() >= 2 && arg[0] == '-' && arg[1] == '-')
+                {
+                    auto eq = arg.find('=', 2);
+                    result.name_size = static_cast<std::uint32_t>((eq != std::string_view::npos ? eq : arg.size()) - 2);
+                    result.kind = arg.size() == 2 ? TokenKind::Terminator :
+                        (eq != std::string_view::npos ? TokenKind::LongWithValue : TokenKind::Long);
+                }
+                else
+                {
+                    result.kind = arg.size() >= 2 && arg[0] == '-' ? TokenKind::ShortCluster : TokenKind::Word;
+                    result.name_size = result.kind == TokenKind::ShortCluster ? result.size - 1 : result.size;
+                }
+                return result;
+            }
+            std::string_view
+                text() const
+            {
+                return std::string_view(data, size);
+            }
+            // ShortCluster: the characters after '-', Long(WithValue): the characters between "--" and '=', Word: the whole text
+            std::string_view
+                name() const
+            {
+                std::size_t offset = kind == TokenKind::Word ? 0 : (kind == TokenKind::ShortCluster ? 1 : 2);
+                return std::string_view(data + offset, name_size);
+            }
+            // ShortCluster: the characters attached to the first short name without a leading '=' (-ta, -t=a),
+            // LongWithValue: the characters after '='
+            std::string_view
+                value() const
+            {
+                std::string_view result;
+                if (kind == TokenKind::LongWithValue)
+                {
+                    result = std::string_view(data + name_size + 3, size - name_size - 3);
+                }
+                else if (kind == TokenKind::ShortCluster)
+                {
+                    std::size_t offset = size > 2 && data[2] == '=' ? 3 : 2;
+                    result = std::string_view(data + offset, size - offset);
+                }
+                return result;
+            }
+        };
+        // Splits the line [data, data + size) in place into '\0'-terminated words following the quoting rules of
+        // a POSIX shell: blanks separate words, '...' is taken literally, inside "..." a backslash only escapes
+        // $ ` " \ and newline, outside of quotes it escapes any character and a backslash-newline is removed.
+        // No expansions are done. data[size] has to be writable, returns the size of the split words. quote is set
+        // to the quote left open at the end of the line or 0
+        inline std::size_t
+            split_command_line(char* data, std::size_t size, char& quote)
+        {
+            std::size_t w = 0;
+            quote = 0;
+            bool in_word = false;
+            for (std::size_t r = 0; r < size; r++)
+            {
+                char c = data[r];
+                if (quote == '\'')
+                {
+                    if (c == '\'')
+                    {
+                        quote = 0;
+                    }
+                    else
+                    {
+                        data[w++] = c;
+                    }
+                }
+                else if (quote == '"')
+                {
+                    if (c == '"')
+                    {
+                        quote = 0;
+                    }
+                    else if (c == '\\' && r + 1 < size && data[r + 1] != 0 && std::strchr("$`\"\\\n", data[r + 1]) != nullptr)
+                    {
+                        r++;
+                        if (data[r] != '\n')
+                        {
+                            data[w++] = data[r];
+                        }
+                    }
+                    else
+                    {
+                        data[w++] = c;
+                    }
+                }
+                else if (c == ' ' || c == '\t' || c == '\n')
+                {
+                    if (in_word)
+                    {
+                        data[w++] = '\0';
+                        in_word = false;
+                    }
+                }
+                else if (c == '\\' && r + 1 < size && data[r + 1] == '\n')
+                {
+                    r++;
+                }
+                else
+                {
+                    in_word = true;
+                    if (c == '\'' || c == '"')
+                    {
+                        quote = c;
+                    }
+                    else if (c == '\\' && r + 1 < size)
+                    {
+                        data[w++] = data[++r];
+                    }
+                    else
+                    {
+                        data[w++] = c;
+                    }
+                }
+            }
+            if (in_word)
+            {
+                data[w++] = '\0';
+            }
+            return w;
+        }
+        inline error
+            missing_quote_error(char quote)
+        {
+            return error(ErrorCode::MissingClosingQuote, error::npos, {}, quote == '"' ? "\"" : "'");
+        }
+        inline std::size_t
+            split_command_line(char* data, std::size_t size)
+        {
+            char quote = 0;
+            auto result = split_command_line(data, size, quote);
+            if (quote != 0)
+            {
+                throw std::runtime_error(missing_quote_error(quote).message());
+            }
+            return result;
+        }
+        // Hands out the tokens of a command line one at a time, see parser::argument_source
+        class token_source
         {
         public:
-            virtual int
-                operator()() = 0;
+            virtual ~token_source() = default;
+            // Appends the next token to the tokens of the parse, returns false at the end of the command line
             virtual bool
-                parsed() const = 0;
+                next() = 0;
+        };
+        // Cursor over the tokens of a parse. Without a source all tokens are classified before the parse, with one
+        // they are pulled from it when the cursor reaches the last token read so far
+        class token_stream
+        {
+        public:
+            token_stream(std::pmr::vector<token>& tokens, std::string_view program_name, token_source* source = nullptr)
+                : _tokens(&tokens)
+                , _source(source)
+                , _program_name(program_name)
+            {}
+            bool
+                empty() const
+            {
+                return _pos - _base == _tokens->size() && (_source == nullptr || !_source->next());
+            }
+            // Tokens read so far that haven't been consumed
+            std::size_t
+                remaining() const
+            {
+                return _tokens->size() - (_pos - _base);
+            }
+            std::size_t
+                position() const
+            {
+                return _pos;
+            }
+            const token&
+                peek() const
+            {
+                return (*_tokens)[_pos - _base];
+            }
+            const token&
+                last() const
+            {
+                return (*_tokens)[_pos - _base - 1];
+            }
+            void
+                advance()
+            {
+                _pos++;
+            }
+            // Forgets the consumed tokens once every token read from the source has been consumed, so a parse
+            // streaming its arguments doesn't grow with their number. last() is invalid afterwards
+            void
+                release()
+            {
+                if (_source != nullptr && _pos - _base == _tokens->size())
+                {
+                    _base = _pos;
+                    _tokens->clear();
+                }
+            }
+            std::string_view
+                program_name() const
+            {
+                return _program_name;
+            }
+
+        private:
+            std::pmr::vector<token>* _tokens;
+            token_source* _source;
+            std::size_t _pos{0};
+            std::size_t _base{0};
+            std::string_view _program_name;
+        };
+        // Glob matcher for all Pattern options of a group, every '*' matches any (possibly empty) sequence of
+        // characters. All patterns are compiled into one bit parallel NFA, so a name gets classified against
+        // every pattern in a single pass over its bytes
+        class pattern_matcher
+        {
+        public:
+            static constexpr std::size_t npos = std::size_t(-1);
+
+            static std::size_t
+                capture_count(std::string_view pattern)
+            {
+                std::size_t result = 0;
+                for (std::size_t i = 0; i < pattern.size(); i++)
+                {
+                    if (pattern[i] == '*' && (i == 0 || pattern[i - 1] != '*'))
+                    {
+                        result++;
+                    }
+                }
+                return result;
+            }
+            std::size_t
+                add(std::string_view pattern)
+            {
+                _patterns.push_back(pattern);
+                return _patterns.size() - 1;
+            }
+            std::size_t
+                size() const
+            {
+                return _patterns.size();
+            }
+            // Returns the id of the first added pattern matching the whole text or npos
+            std::size_t
+                match(std::string_view text) const
+            {
+                std::size_t result = npos;
+                if (!_patterns.empty())
+                {
+                    std::array<std::uint64_t, 2 * max_stack_words> stack_words;
+                    std::vector<std::uint64_t> heap_words;
+                    std::uint64_t* d = stack_words.data();
+                    if (_words > max_stack_words)
+                    {
+                        heap_words.resize(2 * _words);
+                        d = heap_words.data();
+                    }
+                    std::uint64_t* next = d + _words;
+                    bool any = false;
+                    for (std::size_t w = 0; w < _words; w++)
+                    {
+                        d[w] = _first[w] & _star[w];
+                        any = any || d[w] != 0;
+                    }
+                    bool first = true;
+                    for (char c : text)
+                    {
+                        const std::uint64_t* mask = &_char_masks[static_cast<unsigned char>(c) * _words];
+                        std::uint64_t carry = 0;
+                        any = false;
+                        for (std::size_t w = 0; w < _words; w++)
+                        {
+                            auto shifted = ((d[w] << 1) | carry) & ~_first[w];
+                            carry = d[w] >> 63;
+                            next[w] = ((shifted | (first ? _first[w] : 0)) & mask[w]) | (d[w] & _star[w]);
+                        }
+                        carry = 0;
+                        for (std::size_t w = 0; w < _words; w++)
+                        {
+                            auto shifted = ((next[w] << 1) | carry) & ~_first[w];
+                            carry = next[w] >> 63;
+                            next[w] |= shifted & _star[w];
+                            any = any || next[w] != 0;
+                        }
+                        std::swap(d, next);
+                        first = false;
+                        if (!any)
+                        {
+                            break;
+                        }
+                    }
+                    for (std::size_t w = 0; any && result == npos && w < _words; w++)
+                    {
+                        auto accepted = d[w] & _last[w];
+                        if (accepted != 0)
+                        {
+                            result = _owner[w * 64 + static_cast<std::size_t>(std::countr_zero(accepted))];
+                        }
+                    }
+                }
+                return result;
+            }
+            // Splits a text already matched by the pattern with the given id into the segments matched by the
+            // '*'s, the segments are views into text
+            void
+                extract(std::size_t id, std::string_view text, std::span<std::string_view> captures) const
+            {
+                std::string_view pattern = _patterns[id];
+                auto star = pattern.find('*');
+                std::size_t pos = star == std::string_view::npos ? text.size() : star;
+                for (std::size_t i = 0; star != std::string_view::npos && i < captures.size(); i++)
+                {
+                    auto begin = pattern.find_first_not_of('*', star);
+                    star = pattern.find('*', begin);
+                    auto literal = pattern.substr(std::min(begin, pattern.size()), star - std::min(begin, pattern.size()));
+                    auto end = star == std::string_view::npos ? text.size() - literal.size() : text.find(literal, pos);
+                    captures[i] = text.substr(pos, end - pos);
+                    pos = end + literal.size();
+                }
+            }
+
+            void
+                build()
+            {
+                std::size_t positions = 0;
+                for (auto p : _patterns)
+                {
+                    positions += p.size() - std::count(p.begin(), p.end(), '*') + capture_count(p);
+                }
+                _words = std::max<std::size_t>(1, (positions + 63) / 64);
+                _char_masks.assign(256 * _words, 0);
+                _star.assign(_words, 0);
+                _first.assign(_words, 0);
+                _last.assign(_words, 0);
+                _owner.assign(_words * 64, npos);
+                std::size_t bit = 0;
+                auto set = [](std::vector<std::uint64_t>& v, std::size_t b) { v[b / 64] |= std::uint64_t(1) << (b % 64); };
+                for (std::size_t id = 0; id < _patterns.size(); id++)
+                {
+                    auto p = _patterns[id];
+                    bool first = true;
+                    for (std::size_t i = 0; i < p.size(); i++)
+                    {
+                        if (p[i] == '*' && i > 0 && p[i - 1] == '*')
+                        {
+                            continue;
+                        }
+                        if (first)
+                        {
+                            set(_first, bit);
+                            first = false;
+                        }
+                        if (p[i] == '*')
+                        {
+                            set(_star, bit);
+                            for (std::size_t c = 0; c < 256; c++)
+                            {
+                                _char_masks[c * _words + bit / 64] |= std::uint64_t(1) << (bit % 64);
+                            }
+                        }
+                        else
+                        {
+                            _char_masks[static_cast<unsigned char>(p[i]) * _words + bit / 64] |= std::uint64_t(1) << (bit % 64);
+                        }
+                        _owner[bit] = id;
+                        bit++;
+                    }
+                    if (!first)
+                    {
+                        set(_last, bit - 1);
+                    }
+                }
+            }
+
+            std::size_t
+                heap_size() const
+            {
+                return _patterns.capacity() * sizeof(std::string_view) + _owner.capacity() * sizeof(std::size_t)
+                    + (_char_masks.capacity() + _star.capacity() + _first.capacity() + _last.capacity()) * sizeof(std::uint64_t);
+            }
+
+        private:
+            static constexpr std::size_t max_stack_words = 8;
+
+            std::vector<std::string_view> _patterns;
+            std::vector<std::uint64_t> _char_masks;
+            std::vector<std::uint64_t> _star;
+            std::vector<std::uint64_t> _first;
+            std::vector<std::uint64_t> _last;
+            std::vector<std::size_t> _owner;
+            std::size_t _words{0};
+        };
+        class base_value;
+        // Values of one option for every line of a batch_result
+        class base_column
+        {
+        public:
+            virtual ~base_column() = default;
+            virtual void
+                set(std::size_t line, const base_value& value, std::pmr::memory_resource* mr) = 0;
+        };
+        template <class T>
+        class column;
+        class base_value
+        {
+        public:
+            virtual ~base_value() = default;
+            virtual void
+                reset() = 0;
+            // Drops everything allocated from the memory resource of the result
+            virtual void
+                release() = 0;
+            // Called once all arguments are parsed
+            virtual error
+                finish()
+            {
+                return error();
+            }
+            // Converts arguments that lazy options kept as text
+            virtual error
+                try_convert()
+            {
+                return error();
+            }
+            void
+                convert()
+            {
+                auto e = try_convert();
+                if (e)
+                {
+                    throw std::runtime_error(e.message());
+                }
+            }
+            virtual std::unique_ptr<base_column>
+                make_column(std::size_t) const
+            {
+                return nullptr;
+            }
+        };
+        // Result of a single option inside a parse_result, reset restores the initial value. data allocates from
+        // the memory resource of the result, the initial value lives on the default resource so it survives
+        // releasing an arena
+        template <class T>
+        class value
+            : public base_value
+        {
+        public:
+            value(T initial, std::pmr::memory_resource* mr)
+                : data(std::make_obj_using_allocator<T>(std::pmr::polymorphic_allocator<>(mr), initial))
+                , _initial(std::move(initial))
+            {}
+            virtual void
+                reset() override
+            {
+                data = _initial;
+            }
+            virtual void
+                release() override
+            {
+                if constexpr (requires { data.get_allocator(); })
+                {
+                    auto alloc = data.get_allocator();
+                    std::destroy_at(&data);
+                    std::construct_at(&data, alloc);
+                }
+                else if constexpr (requires { data.reset(); })
+                {
+                    data.reset();
+                }
+            }
+            virtual error
+                finish() override
+            {
+                if constexpr (requires { data.finish(); })
+                {
+                    data.finish();
+                }
+                return error();
+            }
+            virtual std::unique_ptr<base_column>
+                make_column(std::size_t lines) const override
+            {
+                return std::make_unique<column<T>>(lines, _initial);
+            }
+
+            T data;
+
+        private:
+            T _initial;
+        };
+        // Starts out with the initial value on every line. Copies of values that allocate are made from mr, an arena
+        // of the batch_result, so they outlive the results they came from without going through the heap line by
+        // line. For bool data is a std::vector<bool>, whose words hold 64 lines, so a block of 64 lines has to be
+        // written by a single thread
+        template <class T>
+        class column
+            : public base_column
+        {
+        public:
+            column(std::size_t lines, const T& initial)
+                : data(lines, initial)
+            {}
+            virtual void
+                set(std::size_t line, const base_value& v, std::pmr::memory_resource* mr) override
+            {
+                const T& source = static_cast<const value<T>&>(v).data;
+                if constexpr (std::uses_allocator_v<T, std::pmr::polymorphic_allocator<>>)
+                {
+                    T copy = std::make_obj_using_allocator<T>(std::pmr::polymorphic_allocator<>(mr), source);
+                    std::destroy_at(&data[line]);
+                    std::construct_at(&data[line], std::move(copy));
+                }
+                else
+                {
+                    data[line] = source;
+                }
+            }
+
+            std::vector<T> data;
+        };
+        // Same as value but reset only clears the container, so its capacity is kept, vectors are reserved for
+        // reserve elements
+        template <class T>
+        class container_value
+            : public value<T>
+        {
+        public:
+            container_value(std::pmr::memory_resource* mr, std::size_t reserve = 0)
+                : value<T>(T(), mr)
+                , _reserve(reserve)
+            {
+                reset();
+            }
+            virtual void
+                reset() override
+            {
+                value<T>::data.clear();
+                if constexpr (requires { value<T>::data.reserve(_reserve); })
+                {
+                    value<T>::data.reserve(_reserve);
+                }
+            }
+
+        private:
+            std::size_t _reserve;
+        };
+        // Keeps the text of the arguments of option name and converts it into data on first access. Texts are
+        // converted only once, a failed conversion is retried and fails again on the next access. The error names
+        // the option and the index of the token the text came from, like the error of a parse would
+        template <class T, class Base = value<T>>
+        class lazy_value
+            : public Base
+        {
+        public:
+            using convert_t = std::errc (*)(T& data, std::string_view text, std::pmr::memory_resource* mr);
+            struct deferred
+            {
+                std::string_view text;
+                std::size_t token;
+            };
+
+            template <class... Args>
+            lazy_value(convert_t convert, std::string_view name, std::pmr::memory_resource* mr, Args&&... args)
+                : Base(std::forward<Args>(args)...)
+                , _convert(convert)
+                , _name(name)
+                , _texts(mr)
+            {}
+            void
+                add(std::string_view text, std::size_t token)
+            {
+                _texts.push_back({text, token});
+            }
+            virtual void
+                reset() override
+            {
+                Base::reset();
+                _texts.clear();
+                _converted = 0;
+            }
+            virtual void
+                release() override
+            {
+                Base::release();
+                auto alloc = _texts.get_allocator();
+                std::destroy_at(&_texts);
+                std::construct_at(&_texts, alloc);
+                _converted = 0;
+            }
+            virtual error
+                try_convert() override
+            {
+                for (; _converted < _texts.size(); _converted++)
+                {
+                    auto ec = _convert(Base::data, _texts[_converted].text, _texts.get_allocator().resource());
+                    if (ec != std::errc{})
+                    {
+                        return error::conversion(ec, _texts[_converted].token, _texts[_converted].text, _name);
+                    }
+                }
+                return error();
+            }
+
+        protected:
+            convert_t _convert;
+            std::string_view _name;
+            std::pmr::vector<deferred> _texts;
+            std::size_t _converted{0};
+        };
+        // Threads shared by everything po does in parallel, one per core besides the calling thread, started on
+        // first use. run blocks until every task is done. A run while another one is in progress, or from inside a
+        // task, runs its tasks on the calling thread
+        class worker_pool
+        {
+        public:
+            // Cores to spread work over, at least 1
+            static std::size_t
+                concurrency()
+            {
+                static const std::size_t result = std::max(1u, std::thread::hardware_concurrency());
+                return result;
+            }
+            static worker_pool&
+                instance()
+            {
+                static worker_pool pool(concurrency() - 1);
+                return pool;
+            }
+            worker_pool(const worker_pool&) = delete;
+            worker_pool&
+                operator=(const worker_pool&) = delete;
+            ~worker_pool()
+            {
+                {
+                    std::lock_guard lock(_mutex);
+                    _stop = true;
+                }
+                _wake.notify_all();
+                for (auto& thread : _threads)
+                {
+                    thread.join();
+                }
+            }
+            // Threads run uses, the calling thread included
+            std::size_t
+                size() const
+            {
+                return _threads.size() + 1;
+            }
+            // Calls f(t) for every t < tasks
+            template <class F>
+            void
+                run(std::size_t tasks, F&& f)
+            {
+                job j{[](void* ctx, std::size_t t) { (*static_cast<std::remove_reference_t<F>*>(ctx))(t); }, &f, tasks};
+                std::unique_lock busy(_busy, std::try_to_lock);
+                if (!busy || in_task() || _threads.empty() || tasks < 2)
+                {
+                    execute(j);
+                    return;
+                }
+                {
+                    std::lock_guard lock(_mutex);
+                    _job = &j;
+                    _generation++;
+                }
+                _wake.notify_all();
+                execute(j);
+                std::unique_lock lock(_mutex);
+                _job = nullptr;
+                _idle.wait(lock, [&j] { return j.active == 0; });
+            }
+
+        private:
+            struct job
+            {
+                void (*call)(void* ctx, std::size_t t);
+                void* ctx;
+                std::size_t tasks;
+                std::atomic<std::size_t> next{0};
+                std::size_t active{0};
+            };
+
+            explicit worker_pool(std::size_t threads)
+            {
+                _threads.reserve(threads);
+                for (std::size_t i = 0; i < threads; i++)
+                {
+                    _threads.emplace_back([this] { loop(); });
+                }
+            }
+            static bool&
+                in_task()
+            {
+                thread_local bool result = false;
+                return result;
+            }
+            static void
+                execute(job& j)
+            {
+                bool outer = in_task();
+                in_task() = true;
+                for (auto t = j.next++; t < j.tasks; t = j.next++)
+                {
+                    j.call(j.ctx, t);
+                }
+                in_task() = outer;
+            }
+            void
+                loop()
+            {
+                std::size_t generation = 0;
+                std::unique_lock lock(_mutex);
+                while (!_stop)
+                {
+                    _wake.wait(lock, [&] { return _stop || _generation != generation; });
+                    generation = _generation;
+                    job* j = _job;
+                    if (j != nullptr && !_stop)
+                    {
+                        j->active++;
+                        lock.unlock();
+                        execute(*j);
+                        lock.lock();
+                        if (--j->active == 0)
+                        {
+                            _idle.notify_all();
+                        }
+                    }
+                }
+            }
+
+            std::vector<std::thread> _threads;
+            std::mutex _busy;
+            std::mutex _mutex;
+            std::condition_variable _wake;
+            std::condition_variable _idle;
+            job* _job{nullptr};
+            std::size_t _generation{0};
+            bool _stop{false};
+        };
+        // Values of multi_argument, which converts after parsing or, if lazy, on first access. Once there are at
+        // least parallel texts they are converted in one slice per core on the worker_pool, every slice writing its
+        // own part of the vector. Only done for trivially copyable types, whose conversion doesn't allocate, neither
+        // from the memory resource of the result, which doesn't have to be thread safe, nor from the heap
+        template <class E>
+        class bulk_value
+            : public lazy_value<std::pmr::vector<helper::result_type_t<E>>, container_value<std::pmr::vector<helper::result_type_t<E>>>>
+        {
+        public:
+            using element_t = helper::result_type_t<E>;
+            using data_t = std::pmr::vector<element_t>;
+            using base1_t = lazy_value<data_t, container_value<data_t>>;
+            static constexpr bool parallel_safe = std::is_same_v<element_t, E> && std::is_trivially_copyable_v<element_t>;
+
+            bulk_value(std::string_view name, std::pmr::memory_resource* mr, std::size_t reserve, std::size_t parallel, bool lazy)
+                : base1_t([](data_t& data, std::string_view text, std::pmr::memory_resource* mr_)
+                      {
+                          std::optional<element_t> value;
+                          auto ec = helper::try_lexical_cast<E>(text, value, mr_);
+                          if (value)
+                          {
+                              data.push_back(std::move(*value));
+                          }
+                          return ec;
+                      }, name, mr, mr, reserve)
+                , _parallel(parallel)
+                , _lazy(lazy)
+            {}
+            virtual error
+                finish() override
+            {
+                return _lazy ? error() : try_convert();
+            }
+            virtual error
+                try_convert() override
+            {
+                std::size_t count = base1_t::_texts.size() - base1_t::_converted;
+                if constexpr (parallel_safe)
+                {
+                    if (_parallel != 0 && count >= _parallel && worker_pool::concurrency() > 1)
+                    {
+                        auto result = convert_parallel(count);
+                        if (result)
+                        {
+                            return result;
+                        }
+                    }
+                }
+                return base1_t::try_convert();
+            }
+
+        private:
+            // Every slice stops at its first text that doesn't convert, the error of the earliest one is returned
+            error
+                convert_parallel(std::size_t count)
+            {
+                auto& pool = worker_pool::instance();
+                auto& data = base1_t::data;
+                std::size_t offset = data.size();
+                std::size_t slices = std::min(pool.size(), count);
+                std::vector<std::pair<std::size_t, std::errc>> errors(slices, {count, std::errc{}});
+                data.resize(offset + count);
+                pool.run(slices, [&](std::size_t s)
+                    {
+                        std::size_t end = count * (s + 1) / slices;
+                        for (std::size_t i = count * s / slices; i < end; i++)
+                        {
+                            auto ec = converter<E>::from_string(base1_t::_texts[base1_t::_converted + i].text, data[offset + i]);
+                            if (ec != std::errc{})
+                            {
+                                errors[s] = {i, ec};
+                                break;
+                            }
+                        }
+                    });
+                for (auto& [i, ec] : errors)
+                {
+                    if (ec != std::errc{})
+                    {
+                        data.resize(offset);
+                        const auto& d = base1_t::_texts[base1_t::_converted + i];
+                        return error::conversion(ec, d.token, d.text, base1_t::_name);
+                    }
+                }
+                base1_t::_converted += count;
+                return error();
+            }
+
+            std::size_t _parallel;
+            bool _lazy;
+        };
+        // Vector of key value pairs, appended to while parsing and sorted once by finish. Like for
+        // std::map::insert_or_assign a later occurrence of a key replaces an earlier one
+        template <class K, class V>
+        class flat_map
+        {
+        public:
+            using key_type = K;
+            using mapped_type = V;
+            using value_type = std::pair<K, V>;
+            using allocator_type = std::pmr::polymorphic_allocator<value_type>;
+            using const_iterator = typename std::pmr::vector<value_type>::const_iterator;
+            using iterator = const_iterator;
+
+            flat_map() = default;
+            explicit flat_map(const allocator_type& alloc)
+                : _data(alloc)
+            {}
+            flat_map(const flat_map& other, const allocator_type& alloc)
+                : _data(other._data, alloc)
+            {}
+            flat_map(const flat_map&) = default;
+            flat_map&
+                operator=(const flat_map&) = default;
+
+            void
+                insert_or_assign(K key, V value)
+            {
+                _data.emplace_back(std::move(key), std::move(value));
+            }
+            void
+                finish()
+            {
+                std::stable_sort(_data.begin(), _data.end(), [](const value_type& a, const value_type& b)
+                    {
+                        return a.first < b.first;
+                    });
+                auto out = _data.begin();
+                for (auto it = _data.begin(); it != _data.end(); it++)
+                {
+                    auto next = std::next(it);
+                    if (next == _data.end() || it->first < next->first)
+                    {
+                        if (out != it)
+                        {
+                            *out = std::move(*it);
+                        }
+                        out++;
+                    }
+                }
+                _data.erase(out, _data.end());
+            }
+            template <class Q>
+            const_iterator
+                find(const Q& key) const
+            {
+                auto it = std::lower_bound(_data.begin(), _data.end(), key, [](const value_type& e, const Q& k)
+                    {
+                        return e.first < k;
+                    });
+                return it != _data.end() && !(key < it->first) ? it : _data.end();
+            }
+            template <class Q>
+            bool
+                contains(const Q& key) const
+            {
+                return find(key) != end();
+            }
+            template <class Q>
+            const V&
+                at(const Q& key) const
+            {
+                auto it = find(key);
+                if (it == end())
+                {
+                    throw std::out_of_range("po error: key not found");
+                }
+                return it->second;
+            }
+            const_iterator
+                begin() const
+            {
+                return _data.begin();
+            }
+            const_iterator
+                end() const
+            {
+                return _data.end();
+            }
+            std::size_t
+                size() const
+            {
+                return _data.size();
+            }
+            bool
+                empty() const
+            {
+                return _data.empty();
+            }
+            void
+                clear()
+            {
+                _data.clear();
+            }
+            void
+                reserve(std::size_t size)
+            {
+                _data.reserve(size);
+            }
+            allocator_type
+                get_allocator() const
+            {
+                return _data.get_allocator();
+            }
+
+        private:
+            std::pmr::vector<value_type> _data;
+        };
+        // Open addressing hash table with linear probing. The pairs are kept in insertion order in one array, the
+        // table only holds their indices. Strings are hashed as std::string_view, so a std::string_view finds a
+        // std::pmr::string key
+        template <class K, class V>
+        class hash_map
+        {
+        public:
+            using key_type = K;
+            using mapped_type = V;
+            using value_type = std::pair<K, V>;
+            using allocator_type = std::pmr::polymorphic_allocator<value_type>;
+            using const_iterator = typename std::pmr::vector<value_type>::const_iterator;
+            using iterator = const_iterator;
+
+            hash_map() = default;
+            explicit hash_map(const allocator_type& alloc)
+                : _entries(alloc)
+                , _slots(alloc)
+            {}
+            hash_map(const hash_map& other, const allocator_type& alloc)
+                : _entries(other._entries, alloc)
+                , _slots(other._slots, alloc)
+            {}
+            hash_map(const hash_map&) = default;
+            hash_map&
+                operator=(const hash_map&) = default;
+
+            void
+                insert_or_assign(K key, V value)
+            {
+                if ((_entries.size() + 1) * 2 > _slots.size())
+                {
+                    rehash(std::max<std::size_t>(16, _slots.size() * 2));
+                }
+                auto [slot, found] = lookup(key);
+                if (found)
+                {
+                    _entries[_slots[slot] - 1].second = std::move(value);
+                }
+                else
+                {
+                    _entries.emplace_back(std::move(key), std::move(value));
+                    _slots[slot] = static_cast<std::uint32_t>(_entries.size());
+                }
+            }
+            template <class Q>
+            const_iterator
+                find(const Q& key) const
+            {
+                auto result = _entries.end();
+                if (!_slots.empty())
+                {
+                    auto [slot, found] = lookup(key);
+                    result = found ? _entries.begin() + (_slots[slot] - 1) : _entries.end();
+                }
+                return result;
+            }
+            template <class Q>
+            bool
+                contains(const Q& key) const
+            {
+                return find(key) != end();
+            }
+            template <class Q>
+            const V&
+                at(const Q& key) const
+            {
+                auto it = find(key);
+                if (it == end())
+                {
+                    throw std::out_of_range("po error: key not found");
+                }
+                return it->second;
+            }
+            const_iterator
+                begin() const
+            {
+                return _entries.begin();
+            }
+            const_iterator
+                end() const
+            {
+                return _entries.end();
+            }
+            std::size_t
+                size() const
+            {
+                return _entries.size();
+            }
+            bool
+                empty() const
+            {
+                return _entries.empty();
+            }
+            void
+                clear()
+            {
+                _entries.clear();
+                std::fill(_slots.begin(), _slots.end(), 0);
+            }
+            void
+                reserve(std::size_t size)
+            {
+                _entries.reserve(size);
+                if (size * 2 > _slots.size())
+                {
+                    rehash(std::bit_ceil(size * 2));
+                }
+            }
+            allocator_type
+                get_allocator() const
+            {
+                return _entries.get_allocator();
+            }
+
+        private:
+            template <class Q>
+            static std::size_t
+                hash(const Q& key)
+            {
+                std::uint64_t h;
+                if constexpr (std::is_convertible_v<const Q&, std::string_view>)
+                {
+                    h = std::hash<std::string_view>()(key);
+                }
+                else
+                {
+                    h = std::hash<Q>()(key);
+                }
+                h ^= h >> 33;
+                h *= 0xff51afd7ed558ccdull;
+                h ^= h >> 33;
+                return static_cast<std::size_t>(h);
+            }
+            template <class Q>
+            std::pair<std::size_t, bool>
+                lookup(const Q& key) const
+            {
+                std::size_t mask = _slots.size() - 1;
+                std::size_t i = hash(key) & mask;
+                while (_slots[i] != 0 && !(_entries[_slots[i] - 1].first == key))
+                {
+                    i = (i + 1) & mask;
+                }
+                return {i, _slots[i] != 0};
+            }
+            void
+                rehash(std::size_t size)
+            {
+                _slots.assign(size, 0);
+                for (std::size_t i = 0; i < _entries.size(); i++)
+                {
+                    std::size_t slot = hash(_entries[i].first) & (size - 1);
+                    while (_slots[slot] != 0)
+                    {
+                        slot = (slot + 1) & (size - 1);
+                    }
+                    _slots[slot] = static_cast<std::uint32_t>(i + 1);
+                }
+            }
+
+            std::pmr::vector<value_type> _entries;
+            std::pmr::vector<std::uint32_t> _slots;
+        };
+        // Monotonic arena over a buffer it owns, release rewinds to the start of that buffer, only parses not
+        // fitting into it touch the heap
+        class arena
+        {
+        public:
+            arena(std::size_t size)
+                : _buffer(std::make_unique<std::byte[]>(size))
+                , _resource(_buffer.get(), size)
+            {}
+            std::pmr::memory_resource*
+                resource()
+            {
+                return &_resource;
+            }
+            void
+                release()
+            {
+                _resource.release();
+            }
+
+        private:
+            std::unique_ptr<std::byte[]> _buffer;
+            std::pmr::monotonic_buffer_resource _resource;
+        };
+        // Heap allocations of the calling thread, counted by the operator new of PO_INIT_ALLOCATION_STATS
+        struct allocation_counter
+        {
+            static inline thread_local std::size_t count{0};
+            static inline thread_local std::size_t bytes{0};
+            static inline bool installed{false};
+
+            static void
+                add(std::size_t size)
+            {
+                count++;
+                bytes += size;
+            }
+        };
+        // Read only view of a whole file, mapped into memory where mmap is available. A file that can't be read
+        // is empty and reports why in error
+        class mapped_file
+        {
+        public:
+            mapped_file(const std::string& path)
+            {
+#if defined(__unix__) || defined(__APPLE__)
+                int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+                struct stat st;
+                if (fd < 0 || ::fstat(fd, &st) != 0)
+                {
+                    if (fd >= 0)
+                    {
+                        ::close(fd);
+                    }
+                    _error = ErrorCode::ResponseFileOpen;
+                    return;
+                }
+                _id = {static_cast<std::uint64_t>(st.st_dev), static_cast<std::uint64_t>(st.st_ino)};
+                _size = static_cast<std::size_t>(st.st_size);
+                if (_size > 0)
+                {
+                    void* data = ::mmap(nullptr, _size, PROT_READ, MAP_PRIVATE, fd, 0);
+                    if (data == MAP_FAILED)
+                    {
+                        ::close(fd);
+                        _size = 0;
+                        _error = ErrorCode::ResponseFileMap;
+                        return;
+                    }
+                    ::madvise(data, _size, MADV_SEQUENTIAL);
+                    _data = static_cast<const char*>(data);
+                }
+                ::close(fd);
+#else
+                std::ifstream file(path, std::ios::binary);
+                if (!file)
+                {
+                    _error = ErrorCode::ResponseFileOpen;
+                    return;
+                }
+                _buffer.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+                _data = _buffer.data();
+                _size = _buffer.size();
+                _id = {std::hash<std::string>()(std::filesystem::canonical(path).string()), 0};
+#endif
+            }
+            mapped_file(const mapped_file&) = delete;
+            mapped_file&
+                operator=(const mapped_file&) = delete;
+            ~mapped_file()
+            {
+#if defined(__unix__) || defined(__APPLE__)
+                if (_data != nullptr)
+                {
+                    ::munmap(const_cast<char*>(_data), _size);
+                }
+#endif
+            }
+            std::string_view
+                data() const
+            {
+                return std::string_view(_data, _size);
+            }
+            // Identifies the file independent of the path it was opened with
+            std::pair<std::uint64_t, std::uint64_t>
+                id() const
+            {
+                return _id;
+            }
+            ErrorCode
+                error() const
+            {
+                return _error;
+            }
+
+        private:
+            const char* _data{nullptr};
+            std::size_t _size{0};
+            std::pair<std::uint64_t, std::uint64_t> _id;
+            std::string _buffer;
+            ErrorCode _error{ErrorCode::None};
+        };
+        struct option_state
+        {
+            std::string_view parsed_argument;
+            std::string_view parsed_pattern_argument;
+            const token* pattern_token{nullptr};
+            std::size_t parsed_count{0};
+            std::size_t captures_offset{0};
+            std::size_t captures_count{0};
+        };
+        // A state of the parse machine on the stack. phase is where it continues when the state above it
+        // returns. A state reached by After replaces the one before it and returns that one's result
+        struct parse_frame
+        {
+            enum class Phase : std::uint8_t
+            {
+                Enter, Options, SubGroup, BindTo, Positionals, After, RootOptions, RootSubGroup, RootPositionals
+                , RootPositionalsReturn
+            };
+
+            std::uint32_t state;
+            Phase phase{Phase::Enter};
+            ParseStatus result{ParseStatus::NoMatch};
+            bool passes_on{false};
+            ParseStatus passed{ParseStatus::NoMatch};
+            // A subgroup of the group matched
+            bool sub_group{false};
+        };
+    }
+
+    // Everything a single parse produced, the option objects only describe the schema, so any number of
+    // parse_results can be filled concurrently against the same parser. The results are read through the
+    // option objects: result[option]
+    class parse_result
+    {
+    public:
+        // All containers and strings of the result allocate from mr
+        parse_result(std::pmr::memory_resource* mr = std::pmr::get_default_resource())
+            : _resource(mr)
+            , _tokens(mr)
+        {}
+        // The result owns a monotonic arena, reset releases everything the previous parse allocated at once
+        parse_result(std::unique_ptr<detail::arena> arena)
+            : _resource(arena->resource())
+            , _arena(std::move(arena))
+            , _tokens(_resource)
+        {}
+        parse_result(parse_result&&) = default;
+        parse_result&
+            operator=(parse_result&&) = delete;
+
+        template <class Option>
+        decltype(auto)
+            operator[](const Option& option) const
+        {
+            return option.get(*this);
+        }
+        void
+            add_option(std::size_t captures_count, std::unique_ptr<detail::base_value> value)
+        {
+            detail::option_state state;
+            state.captures_offset = _captures.size();
+            state.captures_count = captures_count;
+            _states.push_back(state);
+            _captures.resize(_captures.size() + captures_count);
+            _values.push_back(std::move(value));
+        }
+        // Forgets everything parsed so far, containers keep their capacity unless the result owns an arena
+        void
+            reset()
+        {
+            if (_arena != nullptr)
+            {
+                for (auto& v : _values)
+                {
+                    if (v != nullptr)
+                    {
+                        v->release();
+                    }
+                }
+                _tokens = std::pmr::vector<detail::token>(_resource);
+                _arena->release();
+            }
+            for (auto& state : _states)
+            {
+                state = detail::option_state{std::string_view(), std::string_view(), nullptr, 0,
+                    state.captures_offset, state.captures_count};
+            }
+            for (auto& v : _values)
+            {
+                if (v != nullptr)
+                {
+                    v->reset();
+                }
+            }
+            _tokens.clear();
+            _files.clear();
+            _program_name = std::string_view();
+            _error = po::error();
+            _help_group = nullptr;
+        }
+        detail::option_state&
+            state(std::size_t id)
+        {
+            return _states[id];
+        }
+        const detail::option_state&
+            state(std::size_t id) const
+        {
+            return _states[id];
+        }
+        std::span<std::string_view>
+            captures(std::size_t id)
+        {
+            return std::span<std::string_view>(_captures).subspan(_states[id].captures_offset, _states[id].captures_count);
+        }
+        std::span<const std::string_view>
+            captures(std::size_t id) const
+        {
+            return std::span<const std::string_view>(_captures).subspan(_states[id].captures_offset, _states[id].captures_count);
+        }
+        detail::base_value&
+            value(std::size_t id)
+        {
+            return *_values[id];
+        }
+        const detail::base_value&
+            value(std::size_t id) const
+        {
+            return *_values[id];
+        }
+        bool
+            has_value(std::size_t id) const
+        {
+            return _values[id] != nullptr;
+        }
+        std::pmr::vector<detail::token>&
+            tokens()
+        {
+            return _tokens;
+        }
+        std::pmr::memory_resource*
+            resource() const
+        {
+            return _resource;
+        }
+        void
+            finish()
+        {
+            for (auto& v : _values)
+            {
+                if (v != nullptr)
+                {
+                    fail(v->finish());
+                }
+            }
+        }
+        // Converts the values of all lazy options and returns the error of the first one that doesn't convert.
+        // Afterwards the result can be read from several threads again
+        po::error
+            try_validate()
+        {
+            po::error result;
+            for (auto& v : _values)
+            {
+                if (v != nullptr && !result)
+                {
+                    result = v->try_convert();
+                }
+            }
+            return result;
+        }
+        void
+            validate()
+        {
+            auto e = try_validate();
+            if (e)
+            {
+                throw std::runtime_error(e.message());
+            }
+        }
+        // The first error of a parse is kept, it ends the parse like a help option does
+        void
+            fail(po::error e)
+        {
+            if (e && !stopped())
+            {
+                _error = std::move(e);
+            }
+        }
+        bool
+            failed() const
+        {
+            return bool(_error);
+        }
+        const po::error&
+            error() const
+        {
+            return _error;
+        }
+        void
+            set_help_group(const detail::base_group* group)
+        {
+            if (!stopped())
+            {
+                _help_group = group;
+            }
+        }
+        // Group whose help option ended the parse
+        const detail::base_group*
+            help_group() const
+        {
+            return _help_group;
+        }
+        bool
+            stopped() const
+        {
+            return failed() || _help_group != nullptr;
+        }
+        // Keeps a response file mapped until the next reset, the tokens read from it point into the mapping.
+        // Returns nullptr and records the error if the file can't be read
+        const detail::mapped_file*
+            add_file(const std::string& path)
+        {
+            auto file = std::make_unique<detail::mapped_file>(path);
+            const detail::mapped_file* result = nullptr;
+            if (file->error() != ErrorCode::None)
+            {
+                fail(po::error::file(file->error(), path));
+            }
+            else
+            {
+                _files.push_back(std::move(file));
+                result = _files.back().get();
+            }
+            return result;
+        }
+        // Command line owned by the result, parsed in place by parser::parse_input. The arguments are separated
+        // by '\0' (the format of /proc/<pid>/cmdline), the first one is the program name. Everything parsed from
+        // it (tokens, positionals, string_view arguments and pattern keys) points into this buffer, reset keeps it
+        std::string&
+            input()
+        {
+            return _input;
+        }
+        // Splits line like a POSIX shell would (see detail::split_command_line) into input(), the first word is
+        // the program name. The line is copied once, the words are split inside the buffer. Returns an error if a
+        // quote isn't closed
+        po::error
+            assign_line(std::string_view line)
+        {
+            char quote = 0;
+            _input.assign(line);
+            _input.resize(detail::split_command_line(_input.data(), _input.size(), quote));
+            return quote != 0 ? detail::missing_quote_error(quote) : po::error();
+        }
+        void
+            assign_input(std::span<const std::string_view> args)
+        {
+            _input.clear();
+            for (auto arg : args)
+            {
+                _input.append(arg);
+                _input.push_back('\0');
+            }
+        }
+        std::string_view
+            program_name() const
+        {
+            return _program_name;
+        }
+        void
+            set_program_name(std::string_view program_name)
+        {
+            _program_name = program_name;
+        }
+        // Sink for the events of the parses into this result, see trace_sink
+        void
+            set_trace_sink(trace_sink* sink)
+        {
+            _trace_sink = sink;
+        }
+        trace_sink*
+            get_trace_sink() const
+        {
+            return _trace_sink;
+        }
+        // Parse stack of parser::parse_tokens, kept to reuse its capacity
+        std::vector<detail::parse_frame>&
+            frames()
+        {
+            return _frames;
+        }
+
+    private:
+        std::pmr::memory_resource* _resource;
+        std::unique_ptr<detail::arena> _arena;
+        std::vector<detail::option_state> _states;
+        std::vector<std::string_view> _captures;
+        std::vector<std::unique_ptr<detail::base_value>> _values;
+        std::pmr::vector<detail::token> _tokens;
+        std::string_view _program_name;
+        std::string _input;
+        std::vector<std::unique_ptr<detail::mapped_file>> _files;
+        po::error _error;
+        const detail::base_group* _help_group{nullptr};
+        trace_sink* _trace_sink{nullptr};
+        std::vector<detail::parse_frame> _frames;
+    };
+
+    // Results of parser::parse_batch in columns: the outcome of every line, and for every option a bitmap of the
+    // lines it was parsed on and an array of its values, one per line. Lines the option wasn't parsed on, or
+    // that failed, hold its default. Read through the option objects like a parse_result: batch[option][line].
+    // Values that allocate are copied into one arena per worker, so workers don't share a memory resource
+    class batch_result
+    {
+    public:
+        batch_result(std::size_t lines, const parse_result& prototype, std::size_t options, std::size_t workers = 1)
+            : _lines(lines, ParseStatus::NoMatch)
+            , _words((lines + 63) / 64)
+            , _presence(_words * options, 0)
+        {
+            _arenas.reserve(workers);
+            for (std::size_t w = 0; w < workers; w++)
+            {
+                _arenas.push_back(std::make_unique<detail::arena>(1 << 16));
+            }
+            _columns.reserve(options);
+            for (std::size_t id = 0; id < options; id++)
+            {
+                _columns.push_back(prototype.has_value(id) ? prototype.value(id).make_column(lines) : nullptr);
+            }
+        }
+        batch_result(batch_result&&) = default;
+        batch_result&
+            operator=(batch_result&&) = default;
+
+        std::size_t
+            size() const
+        {
+            return _lines.size();
+        }
+        const po::outcome&
+            line(std::size_t line) const
+        {
+            return _lines[line];
+        }
+        // Values of option for every line, only options storing a value (not flags, groups or string_view
+        // positionals) have a column
+        template <class Option>
+        const std::vector<typename Option::result_t>&
+            operator[](const Option& option) const
+        {
+            auto* c = _columns[option.id()].get();
+            if (c == nullptr)
+            {
+                throw std::runtime_error("po error: option \"" + std::string(option.name()) + "\" has no column");
+            }
+            return static_cast<const detail::column<typename Option::result_t>*>(c)->data;
+        }
+        // Bit line % 64 of word line / 64 is set if option was parsed on line
+        template <class Option>
+        std::span<const std::uint64_t>
+            presence(const Option& option) const
+        {
+            return std::span<const std::uint64_t>(_presence).subspan(option.id() * _words, _words);
+        }
+        template <class Option>
+        bool
+            parsed(const Option& option, std::size_t line) const
+        {
+            return (presence(option)[line / 64] >> (line % 64) & 1) != 0;
+        }
+        void
+            set_line(std::size_t line, po::outcome outcome)
+        {
+            _lines[line] = std::move(outcome);
+        }
+        // Records the value of option id parsed on line by worker. Workers are handed lines in blocks of 64, which
+        // start at a multiple of 64, so every word of the bitmaps and of bool columns is written by one thread
+        void
+            set_value(std::size_t id, std::size_t line, const parse_result& pr, std::size_t worker = 0)
+        {
+            _presence[id * _words + line / 64] |= std::uint64_t(1) << (line % 64);
+            if (_columns[id] != nullptr)
+            {
+                _columns[id]->set(line, pr.value(id), _arenas[worker]->resource());
+            }
+        }
+
+    private:
+        std::vector<po::outcome> _lines;
+        std::size_t _words;
+        std::vector<std::uint64_t> _presence;
+        // Declared before the columns, whose values live in them
+        std::vector<std::unique_ptr<detail::arena>> _arenas;
+        std::vector<std::unique_ptr<detail::base_column>> _columns;
+    };
+
+    namespace detail
+    {
+        // Sends the event made by f to the trace sink of pr. Without PO_TRACE this is empty and f is never called
+        template <class F>
+        void
+            trace(const parse_result& pr, F&& f)
+        {
+            if constexpr (trace_enabled)
+            {
+                if (pr.get_trace_sink() != nullptr)
+                {
+                    pr.get_trace_sink()->event(f());
+                }
+            }
+        }
+        template <class T, class Node>
+        class intrusive_list;
+        // Link of an element of an intrusive_list, an element can be in one list at a time
+        template <class Node>
+        class list_node
+        {
+        private:
+            template <class, class>
+            friend class intrusive_list;
+
+            Node* _next{nullptr};
+        };
+        // Singly linked list threaded through its elements, so options register at startup without allocating
+        template <class T, class Node = T>
+        class intrusive_list
+        {
+        public:
+            class iterator
+            {
+            public:
+                using iterator_category = std::forward_iterator_tag;
+                using value_type = T*;
+                using difference_type = std::ptrdiff_t;
+                using pointer = T* const*;
+                using reference = T* const&;
+
+                iterator() = default;
+                explicit iterator(T* cur)
+                    : _cur(cur)
+                {}
+                T*
+                    operator*() const
+                {
+                    return _cur;
+                }
+                iterator&
+                    operator++()
+                {
+                    _cur = static_cast<T*>(static_cast<list_node<Node>*>(_cur)->_next);
+                    return *this;
+                }
+                iterator
+                    operator++(int)
+                {
+                    auto result = *this;
+                    ++*this;
+                    return result;
+                }
+                bool
+                    operator==(const iterator& other) const
+                {
+                    return _cur == other._cur;
+                }
+                bool
+                    operator!=(const iterator& other) const
+                {
+                    return _cur != other._cur;
+                }
+
+            private:
+                T* _cur{nullptr};
+            };
+
+            void
+                push_back(T* t)
+            {
+                if (_tail != nullptr)
+                {
+                    static_cast<list_node<Node>*>(_tail)->_next = t;
+                }
+                else
+                {
+                    _head = t;
+                }
+                _tail = t;
+                _size++;
+            }
+            iterator
+                begin() const
+            {
+                return iterator(_head);
+            }
+            iterator
+                end() const
+            {
+                return iterator();
+            }
+            std::size_t
+                size() const
+            {
+                return _size;
+            }
+            bool
+                empty() const
+            {
+                return _size == 0;
+            }
+
+        private:
+            T* _head{nullptr};
+            T* _tail{nullptr};
+            std::size_t _size{0};
+        };
+        class base_sub_program
+            : public list_node<base_sub_program>
+        {
+        public:
+            virtual int
+                operator()(const parse_result& pr) = 0;
+            virtual bool
+                parsed(const parse_result& pr) const = 0;
+            virtual std::size_t
+                object_size() const
+            {
+                return sizeof(base_sub_program);
+            }
+        };
+        class base_option
+            : public list_node<base_option>
+        {
+        public:
+            using parent_t = std::optional<std::reference_wrapper<base_group>>;
+            using cparent_t = std::optional<std::reference_wrapper<const base_group>>;
+            static constexpr std::size_t npos = std::size_t(-1);
+
+            base_option(
+                  parent_t parent
+                , std::string_view long_name
+                , char short_name
+                , std::string_view pattern
+                , std::string_view desc
+                , std::string_view arg_name)
+
+                : _parent(parent)
+                , _short_name(short_name)
+                , _long_name(long_name)
+                , _pattern(pattern)
+                , _desc(desc)
+                , _arg_name(arg_name)
+                , _captures_count(pattern_matcher::capture_count(pattern))
+            {}
+            virtual ~base_option() = default;
+            virtual ParseStatus
+                try_parse_option(token_stream& ts, parse_result& pr) const
+            {
+                ParseStatus result = ParseStatus::NoMatch;
+                if (!ts.empty())
+                {
+                    const token& t = ts.peek();
+                    auto& state = pr.state(_id);
+                    if (_pattern == "")
+                    {
+                        switch (t.kind)
+                        {
+                        case TokenKind::Word:
+                            if ((t.size == 1 && _short_name != 0 && t.data[0] == _short_name) ||
+                                (_long_name != "" && t.text() == _long_name))
+                            {
+                                result = ParseStatus::Match;
+                            }
+                            break;
+                        case TokenKind::ShortCluster:
+                            if (_short_name != 0 && t.data[1] == _short_name)
+                            {
+                                result = ParseStatus::Match;
+                            }
+                            break;
+                        case TokenKind::Long:
+                        case TokenKind::LongWithValue:
+                            if (_long_name != "" && t.name() == _long_name)
+                            {
+                                result = ParseStatus::Match;
+                            }
+                            break;
+                        case TokenKind::Terminator:
+                            break;
+                        }
+                    }
+                    else if (state.pattern_token == &t)
+                    {
+                        auto captures = pr.captures(_id);
+                        state.parsed_pattern_argument = captures.empty() ? "" : captures[0];
+                        state.pattern_token = nullptr;
+                        result = ParseStatus::Match;
+                    }
+                    if (result == ParseStatus::Match)
+                    {
+                        state.parsed_argument = t.text();
+                        ts.advance();
+                        state.parsed_count++;
+                    }
+                }
+                return result;
+            }
+            // Called by the parent group after its pattern_matcher classified token as belonging to this option,
+            // the returned span receives the segments matched by the '*'s of the pattern
+            std::span<std::string_view>
+                prepare_pattern_match(const token* t, parse_result& pr) const
+            {
+                pr.state(_id).pattern_token = t;
+                return pr.captures(_id);
+            }
+            std::string_view
+                long_name() const
+            {
+                return _long_name;
+            }
+            char
+                short_name() const
+            {
+                return _short_name;
+            }
+            std::string_view
+                name() const
+            {
+                return _long_name != "" ? _long_name : std::string_view(&_short_name, _short_name != 0 ? 1 : 0);
+            }
+            // -s | --long
+            void
+                print_name(helper::help_writer& w) const
+            {
+                if (short_name() != 0)
+                {
+                    w << '-' << short_name();
+                    if (long_name() != "")
+                    {
+                        w << " | --" << long_name();
+                    }
+                }
+                else
+                {
+                    w << "--" << long_name();
+                }
+            }
+            template <class T>
+            void
+                print_name_argument(helper::help_writer& w, const std::optional<T>& def) const
+            {
+                print_name(w);
+                w << " <" << (arg_name() != "" ? arg_name() : "arg");
+                if (def)
+                {
+                    w << '=';
+                    if constexpr (std::is_same_v<T, char> || std::is_arithmetic_v<T> ||
+                        std::is_convertible_v<const T&, std::string_view>)
+                    {
+                        w << *def;
+                    }
+                    else
+                    {
+                        std::ostringstream ss;
+                        ss << *def;
+                        w << ss.str();
+                    }
+                }
+                w << '>';
+            }
+            void
+                print_name_positional(helper::help_writer& w) const
+            {
+                w << '<' << arg_name() << ">...";
+            }
+            // Groups return themselves, so the After and BindTo chains can be walked without a dynamic_cast
+            virtual const base_group*
+                as_group() const
+            {
+                return nullptr;
+            }
+            // Positionals take any word instead of their name
+            virtual bool
+                positional() const
+            {
+                return false;
+            }
+            // Hands its arguments over while parsing instead of storing them, the parser then reads the command
+            // line as it goes
+            virtual bool
+                streams() const
+            {
+                return false;
+            }
+            bool
+                parsed(const parse_result& pr) const
+            {
+                return pr.state(_id).parsed_argument != "";
+            }
+            bool
+                parsed() const
+            {
+                return parsed(default_result());
+            }
+            bool
+                parsed_as_group(const parse_result& pr) const
+            {
+                auto pa = pr.state(_id).parsed_argument;
+                return pa.size() > 0 && pa[0] != '-';
+            }
+            std::string_view
+                parsed_argument(const parse_result& pr) const
+            {
+                return pr.state(_id).parsed_argument;
+            }
+            std::size_t
+                parsed_count(const parse_result& pr) const
+            {
+                return pr.state(_id).parsed_count;
+            }
+            std::size_t
+                parsed_count() const
+            {
+                return parsed_count(default_result());
+            }
+            void
+                set_parsed_argument(parse_result& pr, std::string_view parsed_argument) const
+            {
+                pr.state(_id).parsed_argument = parsed_argument;
+            }
+            std::string_view
+                parsed_pattern_argument(const parse_result& pr) const
+            {
+                return pr.state(_id).parsed_pattern_argument;
+            }
+            std::span<const std::string_view>
+                parsed_pattern_captures(const parse_result& pr) const
+            {
+                return pr.captures(_id);
+            }
+            void
+                inc_parsed_count(parse_result& pr) const
+            {
+                pr.state(_id).parsed_count++;
+            }
+            std::string_view
+                pattern() const
+            {
+                return _pattern;
+            }
+            std::size_t
+                captures_count() const
+            {
+                return _captures_count;
+            }
+            std::string_view
+                desc() const
+            {
+                return _desc;
+            }
+            std::string_view
+                arg_name() const
+            {
+                return _arg_name;
+            }
+            parent_t
+                parent()
+            {
+                return _parent;
+            }
+            const parent_t
+                parent() const
+            {
+                return _parent;
+            }
+            std::size_t
+                id() const
+            {
+                return _id;
+            }
+            bool
+                frozen() const
+            {
+                return _default_result != nullptr;
+            }
+            // Assigns the slot of this option inside every parse_result of the schema
+            virtual void
+                freeze(std::vector<base_option*>& options)
+            {
+                if (_id == npos)
+                {
+                    _id = options.size();
+                    options.push_back(this);
+                }
+            }
+            void
+                set_default_result(parse_result* pr)
+            {
+                _default_result = pr;
+            }
+            // Result of parser::parse_command_line, read by the conversion operators of the options
+            const parse_result&
+                default_result() const
+            {
+                if (_default_result == nullptr)
+                {
+                    throw std::runtime_error("po error: option \"" + std::string(name()) + "\" accessed before parsing");
+                }
+                return *_default_result;
+            }
+            // Storage of the option in a parse_result, whose containers allocate from the resource of the result.
+            // Created once per result and kept over resets, so the value object itself lives on the heap, not in
+            // an arena. Options like flags and groups only need their option_state and have no value
+            virtual std::unique_ptr<base_value>
+                create_value(std::pmr::memory_resource*) const
+            {
+                return nullptr;
+            }
+            // Checks the parsed count of the option and of everything bound to it, returns the first violation
+            virtual po::error
+                check(const parse_result& pr) const = 0;
+            void
+                notify(const parse_result& pr) const
+            {
+                auto e = check(pr);
+                if (e)
+                {
+                    throw std::runtime_error(e.message());
+                }
+            }
+            virtual void
+                print_help(helper::help_writer& w, std::string_view program_name) const = 0;
+            // Size of the option object and of the heap memory it owns, reported by po::stats
+            virtual std::size_t
+                object_size() const
+            {
+                return sizeof(base_option);
+            }
+            virtual std::size_t
+                heap_size() const
+            {
+                return 0;
+            }
+
+        protected:
+            template <class T>
+            T&
+                value(parse_result& pr) const
+            {
+                return static_cast<detail::value<T>&>(pr.value(_id)).data;
+            }
+            template <class T>
+            const T&
+                value(const parse_result& pr) const
+            {
+                return static_cast<const detail::value<T>&>(pr.value(_id)).data;
+            }
+            template <class V>
+            V&
+                value_object(parse_result& pr) const
+            {
+                return static_cast<V&>(pr.value(_id));
+            }
+            // Converts text, taken from the token at index token, a text that doesn't convert ends the parse with an
+            // Error
+            template <class T>
+            ParseStatus
+                convert_argument(std::string_view text, std::size_t token, parse_result& pr,
+                    std::optional<helper::result_type_t<T>>& value) const
+            {
+                auto ec = helper::try_lexical_cast<T>(text, value, pr.resource());
+                if (ec != std::errc{})
+                {
+                    pr.fail(po::error::conversion(ec, token, text, name()));
+                }
+                return ec == std::errc{} ? ParseStatus::Match : ParseStatus::Error;
+            }
+            // Lazy options convert on first read. This fills in the result but doesn't change what it holds, so
+            // it is done on const results too
+            void
+                convert(const parse_result& pr) const
+            {
+                const_cast<detail::base_value&>(pr.value(_id)).convert();
+            }
+
+        private:
+            parent_t _parent;
+            char _short_name;
+            std::string_view _long_name;
+            std::string_view _pattern;
+            std::string_view _desc;
+            std::string_view _arg_name;
+            std::size_t _captures_count;
+            std::size_t _id{npos};
+            parse_result* _default_result{nullptr};
+        };
+        class option_index
+        {
+        public:
+            struct entry
+            {
+                std::string_view name;
+                base_option* option{nullptr};
+                base_group* group{nullptr};
+            };
+
+            void
+                add(std::string_view long_name, char short_name, base_option* option, base_group* group)
+            {
+                if (short_name != 0)
+                {
+                    auto& e = _short[static_cast<unsigned char>(short_name)];
+                    e.option = e.option == nullptr ? option : e.option;
+                    e.group = e.group == nullptr ? group : e.group;
+                }
+                if (long_name != "")
+                {
+                    _pending.push_back({long_name, option, group});
+                }
+            }
+            const entry*
+                find(char short_name) const
+            {
+                const auto& e = _short[static_cast<unsigned char>(short_name)];
+                return e.option != nullptr || e.group != nullptr ? &e : nullptr;
+            }
+            const entry*
+                find(std::string_view long_name) const
+            {
+                const entry* result = nullptr;
+                if (long_name != "" && !_entries.empty())
+                {
+                    auto h = hash(long_name);
+                    const auto& e = _entries[slot(h, _seeds[(h >> 32) % _seeds.size()], _entries.size() - 1)];
+                    if (e.name == long_name)
+                    {
+                        result = &e;
+                    }
+                }
+                else if (long_name != "")
+                {
+                    auto names = with_prefix(long_name);
+                    result = !names.empty() && names.front().name == long_name ? &names.front() : nullptr;
+                }
+                return result;
+            }
+            // Builds a perfect hash (hash and displace) over the unique long names, the first registered option
+            // and the first registered group win if a name is used more than once. Names whose hashes collide
+            // can't be placed at any size, after a few doublings the sorted names are searched instead
+            void
+                build()
+            {
+                std::vector<entry> keys = std::move(_pending);
+                _pending.clear();
+                std::stable_sort(keys.begin(), keys.end(), [](const auto& lhs, const auto& rhs) { return lhs.name < rhs.name; });
+                std::vector<entry> unique;
+                for (const auto& k : keys)
+                {
+                    if (unique.empty() || unique.back().name != k.name)
+                    {
+                        unique.push_back(k);
+                    }
+                    auto& u = unique.back();
+                    u.option = u.option == nullptr ? k.option : u.option;
+                    u.group = u.group == nullptr ? k.group : u.group;
+                }
+                std::vector<std::uint64_t> hashes;
+                for (const auto& u : unique)
+                {
+                    hashes.push_back(hash(u.name));
+                }
+                std::size_t size = 1;
+                while (size < unique.size())
+                {
+                    size *= 2;
+                }
+                std::size_t bucket_count = std::max<std::size_t>(1, unique.size() / 4);
+                std::vector<std::vector<std::size_t>> buckets(bucket_count);
+                for (std::size_t i = 0; i < unique.size(); i++)
+                {
+                    buckets[(hashes[i] >> 32) % bucket_count].push_back(i);
+                }
+                std::vector<std::size_t> order(bucket_count);
+                for (std::size_t i = 0; i < bucket_count; i++)
+                {
+                    order[i] = i;
+                }
+                std::stable_sort(order.begin(), order.end(), [&](auto lhs, auto rhs) { return buckets[lhs].size() > buckets[rhs].size(); });
+                std::size_t max_size = 16 * size;
+                bool done = false;
+                while (!done && size <= max_size)
+                {
+                    done = true;
+                    _entries.assign(size, entry{});
+                    _seeds.assign(bucket_count, 0);
+                    std::vector<bool> used(size, false);
+                    std::vector<std::size_t> slots;
+                    for (auto b : order)
+                    {
+                        bool placed = false;
+                        for (std::uint32_t seed = 0; !placed && seed < 4096; seed++)
+                        {
+                            slots.clear();
+                            placed = true;
+                            for (auto i : buckets[b])
+                            {
+                                auto s = slot(hashes[i], seed, size - 1);
+                                if (used[s] || std::find(slots.begin(), slots.end(), s) != slots.end())
+                                {
+                                    placed = false;
+                                    break;
+                                }
+                                slots.push_back(s);
+                            }
+                            if (placed)
+                            {
+                                _seeds[b] = seed;
+                                for (std::size_t j = 0; j < slots.size(); j++)
+                                {
+                                    used[slots[j]] = true;
+                                    _entries[slots[j]] = unique[buckets[b][j]];
+                                }
+                            }
+                        }
+                        if (!placed)
+                        {
+                            size *= 2;
+                            done = false;
+                            break;
+                        }
+                    }
+                }
+                if (!done)
+                {
+                    _entries.clear();
+                    _seeds.clear();
+                }
+                _names = std::move(unique);
+            }
+            // Entries whose long name starts with prefix, in name order
+            std::span<const entry>
+                with_prefix(std::string_view prefix) const
+            {
+                auto first = std::lower_bound(_names.begin(), _names.end(), prefix,
+                    [](const entry& e, std::string_view p) { return e.name < p; });
+                auto last = first;
+                while (last != _names.end() && last->name.starts_with(prefix))
+                {
+                    last++;
+                }
+                return {first, last};
+            }
+            const std::array<entry, 256>&
+                short_names() const
+            {
+                return _short;
+            }
+
+            std::size_t
+                heap_size() const
+            {
+                return (_pending.capacity() + _entries.capacity() + _names.capacity()) * sizeof(entry)
+                    + _seeds.capacity() * sizeof(std::uint32_t);
+            }
+
+        private:
+            static std::uint64_t
+                hash(std::string_view name)
+            {
+                std::uint64_t h = 0xcbf29ce484222325ull;
+                for (char c : name)
+                {
+                    h = (h ^ static_cast<unsigned char>(c)) * 0x100000001b3ull;
+                }
+                return h;
+            }
+            static std::size_t
+                slot(std::uint64_t h, std::uint32_t seed, std::size_t mask)
+            {
+                h ^= (seed + 1) * 0x9e3779b97f4a7c15ull;
+                h ^= h >> 33;
+                h *= 0xff51afd7ed558ccdull;
+                h ^= h >> 33;
+                return static_cast<std::size_t>(h) & mask;
+            }
+
+            std::vector<entry> _pending;
+            std::vector<entry> _entries;
+            std::vector<entry> _names;
+            std::vector<std::uint32_t> _seeds;
+            std::array<entry, 256> _short{};
+        };
+        class base_group
+            : public base_option
+        {
+        public:
+            using base1_t = base_option;
+
+            base_group(
+                  parent_t parent
+                , std::string_view name
+                , char short_name
+                , bool optional
+                , std::string_view desc)
+
+                : base1_t(parent, name, short_name, "", desc, "")
+                , _optional(optional)
+            {}
+            void
+                register_option(base_option* bo)
+            {
+                check_not_frozen(bo);
+                _options.push_back(bo);
+            }
+            void
+                register_group(base_group* bg)
+            {
+                check_not_frozen(bg);
+                _groups.push_back(bg);
+            }
+            // The option and the subgroup the next token can start, the FIRST set of the group. A long name, a
+            // short name or a word is looked up once in the index, which holds the option and the group of every
+            // name, patterns are only tried for long names no option has
+            struct candidates
+            {
+                const base_option* option{nullptr};
+                const base_group* group{nullptr};
+            };
+            candidates
+                lookup(const token_stream& ts, parse_result& pr) const
+            {
+                const token& t = ts.peek();
+                candidates result;
+                std::size_t comparisons = 1;
+                switch (t.kind)
+                {
+                case TokenKind::Long:
+                case TokenKind::LongWithValue:
+                    if (const auto* e = _index.find(t.name()))
+                    {
+                        result.option = e->option;
+                    }
+                    break;
+                case TokenKind::ShortCluster:
+                    if (const auto* e = _index.find(t.data[1]))
+                    {
+                        result.option = e->option;
+                    }
+                    break;
+                case TokenKind::Word:
+                {
+                    const option_index::entry* e = t.size == 1 ? _index.find(t.data[0]) : nullptr;
+                    if (e != nullptr)
+                    {
+                        result = {e->option, e->group};
+                    }
+                    if (result.option == nullptr || result.group == nullptr)
+                    {
+                        comparisons += t.size == 1;
+                        e = _index.find(t.text());
+                        result.option = result.option == nullptr && e != nullptr ? e->option : result.option;
+                        result.group = result.group == nullptr && e != nullptr ? e->group : result.group;
+                    }
+                    break;
+                }
+                case TokenKind::Terminator:
+                    comparisons = 0;
+                    break;
+                }
+                if (result.option == nullptr && _patterns.size() > 0 &&
+                    (t.kind == TokenKind::Long || t.kind == TokenKind::LongWithValue))
+                {
+                    comparisons += _patterns.size();
+                    auto id = _patterns.match(t.name());
+                    if (id != pattern_matcher::npos)
+                    {
+                        result.option = _pattern_options[id];
+                        _patterns.extract(id, t.name(), result.option->prepare_pattern_match(&t, pr));
+                    }
+                }
+                trace(pr, [&] { return trace_event{TraceKind::Lookup, ts.position(),
+                    result.option != nullptr ? result.option : result.group, ParseStatus::NoMatch, comparisons}; });
+                return result;
+            }
+            // Parses the option or group a lookup found
+            static ParseStatus
+                try_parse_found(const base_option* bo, token_stream& ts, parse_result& pr)
+            {
+                ParseStatus result = ParseStatus::NoMatch;
+                if (bo != nullptr)
+                {
+                    std::size_t token = ts.position();
+                    result = bo->try_parse_option(ts, pr);
+                    trace(pr, [&] { return trace_event{TraceKind::Parsed, token, bo, result}; });
+                }
+                return result;
+            }
+            void 
+                set_multi_positional_argument(base_option* bo)
+            {
+                check_not_frozen(bo);
+                _multi_positional_argument = bo;
+            }
+            base_option*
+                get_multi_positional_argument()
+            {
+                return _multi_positional_argument;
+            }
+            const base_option*
+                get_multi_positional_argument() const
+            {
+                return _multi_positional_argument;
+            }
+            void
+                set_help_option(base_option* help)
+            {
+                if (_help != nullptr)
+                {
+                    throw std::runtime_error("po error: tryed to set help for \"" + std::string(name()) + "\" twice");
+                }
+                _help = help;
+            }
+            void
+                set_sub_program(base_sub_program* sp)
+            {
+                if (_sub_program != nullptr)
+                {
+                    throw std::runtime_error("po error: tryed to set sub program for \"" + std::string(name()) + "\" twice");
+                }
+                _sub_program = sp;
+            }
+            void
+                set_after(base_option* bo)
+            {
+                check_not_frozen(bo);
+                _after = bo;
+            }
+            void
+                set_bind_to(base_option* bo)
+            {
+                check_not_frozen(bo);
+                _bind_to = bo;
+            }
+            // Appends the options whose --long or -s form starts with word and the --prefix of the patterns word
+            // is a prefix of
+            void
+                complete_options(std::string_view word, std::vector<completion>& candidates) const
+            {
+                if (word == "" || word == "-" || word.starts_with("--"))
+                {
+                    for (const auto& e : _index.with_prefix(word.substr(std::min<std::size_t>(word.size(), 2))))
+                    {
+                        if (e.option != nullptr)
+                        {
+                            candidates.push_back({CompletionKind::Option, "--" + std::string(e.name), e.option});
+                        }
+                    }
+                }
+                if (word.size() <= 2)
+                {
+                    for (std::size_t c = 1; c < 256; c++)
+                    {
+                        const auto* op = _index.short_names()[c].option;
+                        std::string text{'-', static_cast<char>(c)};
+                        if (op != nullptr && text.starts_with(word))
+                        {
+                            candidates.push_back({CompletionKind::Option, std::move(text), op});
+                        }
+                    }
+                }
+                for (const auto* op : _pattern_options)
+                {
+                    auto text = "--" + std::string(op->pattern().substr(0, op->pattern().find('*')));
+                    if (text.starts_with(word))
+                    {
+                        candidates.push_back({CompletionKind::Pattern, std::move(text), op});
+                    }
+                }
+            }
+            // Appends the subgroups whose name starts with word
+            void
+                complete_groups(std::string_view word, std::vector<completion>& candidates) const
+            {
+                for (const auto& e : _index.with_prefix(word))
+                {
+                    if (e.group != nullptr)
+                    {
+                        candidates.push_back({CompletionKind::Group, std::string(e.name), e.group});
+                    }
+                }
+            }
+            // HelpParsed and Error end the whole parse, they are passed up through every group
+            static bool
+                ends_parse(ParseStatus status)
+            {
+                return status == ParseStatus::HelpParsed || status == ParseStatus::Error;
+            }
+            // Appends the tokens two of the options and groups compete for: names used twice, an option and a group
+            // with the same name, long names a pattern matches as well and patterns used twice
+            void
+                find_conflicts(std::vector<conflict>& conflicts) const
+            {
+                std::map<std::string_view, const base_option*> long_names;
+                std::array<const base_option*, 256> short_names{};
+                auto add = [&](const base_option* bo, std::string_view dash)
+                {
+                    if (bo->long_name() != "")
+                    {
+                        auto [it, inserted] = long_names.try_emplace(bo->long_name(), bo);
+                        if (!inserted)
+                        {
+                            auto token = std::string(dash) + std::string(dash) + std::string(bo->long_name());
+                            conflicts.push_back({this, std::move(token), it->second, bo});
+                        }
+                    }
+                    if (bo->short_name() != 0)
+                    {
+                        auto& first = short_names[static_cast<unsigned char>(bo->short_name())];
+                        if (first != nullptr)
+                        {
+                            conflicts.push_back({this, std::string(dash) + bo->short_name(), first, bo});
+                        }
+                        else
+                        {
+                            first = bo;
+                        }
+                    }
+                };
+                for (auto* op : _options)
+                {
+                    if (op->pattern() == "")
+                    {
+                        add(op, "-");
+                        auto id = op->long_name() != "" ? _patterns.match(op->long_name()) : pattern_matcher::npos;
+                        if (id != pattern_matcher::npos)
+                        {
+                            conflicts.push_back({this, "--" + std::string(op->long_name()), op, _pattern_options[id], false});
+                        }
+                    }
+                }
+                std::set<std::string_view> patterns;
+                for (auto* op : _pattern_options)
+                {
+                    if (!patterns.insert(op->pattern()).second)
+                    {
+                        auto first = std::find_if(_pattern_options.begin(), _pattern_options.end(),
+                            [&](const auto* other) { return other->pattern() == op->pattern(); });
+                        conflicts.push_back({this, "--" + std::string(op->pattern()), *first, op});
+                    }
+                }
+                for (auto* bg : _groups)
+                {
+                    add(bg, "");
+                }
+            }
+            virtual void
+                freeze(std::vector<base_option*>& options) override
+            {
+                if (id() != npos)
+                {
+                    return;
+                }
+                base1_t::freeze(options);
+                for (auto* op : _options)
+                {
+                    if (op->pattern() == "")
+                    {
+                        _index.add(op->long_name(), op->short_name(), op, nullptr);
+                    }
+                    else
+                    {
+                        _pattern_options.push_back(op);
+                        _patterns.add(op->pattern());
+                    }
+                }
+                for (auto* bg : _groups)
+                {
+                    _index.add(bg->long_name(), bg->short_name(), nullptr, bg);
+                }
+                _index.build();
+                _patterns.build();
+                for (auto* op : _options)
+                {
+                    op->freeze(options);
+                }
+                for (auto* bg : _groups)
+                {
+                    bg->freeze(options);
+                }
+                for (auto* bo : {_after, _bind_to, _multi_positional_argument})
+                {
+                    if (bo != nullptr)
+                    {
+                        bo->freeze(options);
+                    }
+                }
+            }
+            std::optional<int>
+                execute_main(const parse_result& pr) const
+            {
+                std::optional<int> result = std::nullopt;
+                if (_sub_program != nullptr)
+                {
+                    result = (*_sub_program)(pr);
+                }
+                return result;
+            }
+            const intrusive_list<base_option>&
+                options() const
+            {
+                return _options;
+            }
+            const intrusive_list<base_group, base_option>&
+                groups() const
+            {
+                return _groups;
+            }
+            bool
+                optional() const
+            {
+                return _optional;
+            }
+            bool
+                help_parsed(const parse_result& pr) const
+            {
+                bool result = false;
+                if (_help != nullptr)
+                {
+                    result = _help->parsed(pr);
+                }
+                return result;
+            }
+            base_option*
+                after()
+            {
+                return _after;
+            }
+            const base_option*
+                after() const
+            {
+                return _after;
+            }
+            base_option*
+                bind_to()
+            {
+                return _bind_to;
+            }
+            const base_option*
+                bind_to() const
+            {
+                return _bind_to;
+            }
+            virtual po::error
+                check(const parse_result& pr) const override
+            {
+                po::error result;
+                if (!optional() && !parsed(pr))
+                {
+                    result = po::error(ErrorCode::MissingGroup, po::error::npos, name());
+                }
+                if (parsed(pr))
+                {
+                    for (auto it = options().begin(); !result && it != options().end(); ++it)
+                    {
+                        result = (*it)->check(pr);
+                    }
+                    if (_bind_to != nullptr && !result)
+                    {
+                        result = _bind_to->parsed(pr) ? _bind_to->check(pr) :
+                            po::error(ErrorCode::MissingBound, po::error::npos, name(), _bind_to->name());
+                    }
+                }
+                if (_after != nullptr && !result)
+                {
+                    result = _after->parsed(pr) ? _after->check(pr) :
+                        po::error(ErrorCode::MissingAfter, po::error::npos, _after->name());
+                }
+                return result;
+            }
+            virtual const base_group*
+                as_group() const override
+            {
+                return this;
+            }
+            // Help of the group, rendered on first use and cached for the program name it was rendered for
+            std::string
+                help_text(std::string_view program_name) const
+            {
+                std::lock_guard<std::mutex> lock(_help_text_mutex);
+                if (_help_text.empty() || _help_text_program_name != program_name)
+                {
+                    _help_text.clear();
+                    _help_text.reserve(4096);
+                    helper::help_writer w(_help_text, helper::terminal_width());
+                    print_help(w, program_name);
+                    _help_text_program_name = program_name;
+                }
+                return _help_text;
+            }
+            virtual std::size_t
+                heap_size() const override
+            {
+                std::lock_guard<std::mutex> lock(_help_text_mutex);
+                return _pattern_options.capacity() * sizeof(base_option*) + _patterns.heap_size() + _index.heap_size()
+                    + helper::heap_size(_help_text) + helper::heap_size(_help_text_program_name);
+            }
+            virtual void
+                print_help(helper::help_writer& w, std::string_view program_name) const override
+            {
+                // Synopsis
+                w << "Synopsis:\n  ";
+                auto slash = program_name.find_last_of('/');
+                w << (slash != std::string_view::npos ? program_name.substr(slash + 1) : program_name) << ' ';
+                print_synopsis_parents(w);
+                if (name() != "")
+                {
+                    w << name() << ' ';
+                }
+                if (options().size() > 0)
+                {
+                    w << "[Options...] ";
+                }
+                if (groups().size() > 0)
+                {
+                    w << "[SubGroup] ";
+                }
+                const base_option* cur = _after != nullptr ? _after : _bind_to;
+                bool b_to = false;
+                while (cur != nullptr)
+                {
+                    const base_group* bg_cur = cur->as_group();
+                    if (bg_cur == nullptr)
+                    {
+                        cur->print_name_positional(w);
+                        w << ' ';
+                        break;
+                    }
+                    if (bg_cur->optional() && !b_to)
+                    {
+                        w << '[';
+                        b_to = true;
+                    }
+                    w << cur->long_name() << ' ';
+                    if (bg_cur->bind_to() == nullptr && b_to)
+                    {
+                        w << "] ";
+                        b_to = false;
+                    }
+                    cur = bg_cur->after() != nullptr ? bg_cur->after() : bg_cur->bind_to();
+                }
+                if (get_multi_positional_argument() != nullptr)
+                {
+                    get_multi_positional_argument()->print_name_positional(w);
+                }
+                w << "\n\n";
+                if (desc() != "")
+                {
+                    w << desc() << "\n\n";
+                }
+                if (groups().size() > 0)
+                {
+                    w << "Help:\n";
+                    w << "Type program_name --help for a help overview\n";
+                    w << "and program_name <SubGroup> --help for help on a specifiy SubGroup";
+                    w << "\n\n";
+                }
+                // Synopsis end
+
+                if (options().size() > 0)
+                {
+                    w << "Options:\n";
+                    for (const auto* op : options())
+                    {
+                        op->print_help(w, program_name);
+                    }
+                }
+                if (groups().size() > 0)
+                {
+                    w << "\nSubGroups:\n";
+                    for (const auto* g : groups())
+                    {
+                        w.begin_entry();
+                        w << g->name();
+                        w.end_entry(g->desc());
+                    }
+                }
+                if (get_multi_positional_argument() != nullptr)
+                {
+                    get_multi_positional_argument()->print_help(w, program_name);
+                }
+            }
+
+        private:
+            void
+                check_not_frozen(const base_option* bo) const
+            {
+                if (frozen())
+                {
+                    throw std::runtime_error("po error: \"" + std::string(bo->name()) + "\" registered after the first parse");
+                }
+            }
+            // Names and [Options...] of the groups above this one, outermost first
+            void
+                print_synopsis_parents(helper::help_writer& w) const
+            {
+                if (parent())
+                {
+                    const base_group& bg = parent()->get();
+                    bg.print_synopsis_parents(w);
+                    if (bg.name() != "")
+                    {
+                        w << bg.name() << ' ';
+                    }
+                    if (bg.options().size() > 0)
+                    {
+                        w << "[Options...] ";
+                    }
+                }
+            }
+
+            intrusive_list<base_option> _options;
+            intrusive_list<base_group, base_option> _groups;
+            std::vector<base_option*> _pattern_options;
+            pattern_matcher _patterns;
+            option_index _index;
+            base_option* _help{nullptr};
+            base_sub_program* _sub_program{nullptr};
+            base_option* _after{nullptr};
+            base_option* _bind_to{nullptr};
+            base_option* _multi_positional_argument{nullptr};
+            bool _optional;
+            bool _has_group{false};
+            mutable std::mutex _help_text_mutex;
+            mutable std::string _help_text;
+            mutable std::string _help_text_program_name;
+        };
+        class root_group
+            : public base_group
+        {
+        public:
+            using base1_t = base_group;
+
+            root_group()
+                : base_group(std::nullopt, "", 0, false, "")
+            {}
+            virtual std::size_t
+                object_size() const override
+            {
+                return sizeof(*this);
+            }
+        };
+        // A group, positional or multi positional of the parse machine of a parser, the successors are the indices
+        // of the states a matched group continues with
+        struct parse_state
+        {
+            enum class Kind : std::uint8_t
+            {
+                Root, Group, Positional, Leaf
+            };
+            static constexpr std::uint32_t none = std::uint32_t(-1);
+
+            const base_option* option{nullptr};
+            const base_group* group{nullptr};
+            Kind kind{Kind::Leaf};
+            std::uint32_t bind_to{none};
+            std::uint32_t positionals{none};
+            std::uint32_t after{none};
+        };
+        // What parser::complete collects from the states the parse machine reaches once the words before the
+        // cursor are used up. A positional takes any word, so the states after the first one offer no words
+        struct completion_request
+        {
+            std::string_view word;
+            std::vector<completion>& candidates;
+            bool words_taken{false};
         };
-        class base_group;
-        class base_option
+        class parser
         {
         public:
-            using parent_t = std::optional<std::reference_wrapper<base_group>>;
-            using cparent_t = std::optional<std::reference_wrapper<const base_group>>;
-
-            base_option(
-                  parent_t parent
-                , std::string_view long_name
-                , char short_name
-                , std::string_view pattern
-                , std::string_view desc
-                , std::string_view arg_name)
+            static parser& instance()
+            {
+                return _instance;
+            }
 
-                : _parent(parent)
-                , _long_name(long_name)
-                , _short_name(short_name)
-                , _pattern(pattern)
-                , _desc(desc)
-                , _arg_name(arg_name)
-            {}
-            virtual ParseStatus
-                try_parse_option(int narg, int* argc, const char*** argv)
+            parser() = default;
+            void
+                register_main_group_option(base_option* bo)
             {
-                ParseStatus result = ParseStatus::NoMatch;
-                if (*argc != 0)
-                {
-                    if (_pattern == "")
-                    {
-                        const char* on = **argv;
-                        if (on[0] != 0)
-                        {
-                            if (on[0] != '-')
-                            {
-                                if (on[1] == 0 && _short_name != 0 && on[0] == _short_name)
-                                {
-                                    result = ParseStatus::Match;
-                                }
-                                else if (_long_name != "" && std::strcmp(on, _long_name.data()) == 0)
-                                {
-                                    result = ParseStatus::Match;
-                                }
-                            }
-                            else if (on[1] != '-' && _short_name != 0 && on[1] == _short_name)
-                            {
-                                result = ParseStatus::Match;
-                            }
-                            else if (_long_name != "")
-                            {
-                                auto iter = std::find(on + 2, on + std::strlen(on), '=');
-                                if (std::strncmp(on + 2, _long_name.data(), iter - on - 2) == 0)
-                                {
-                                    result = ParseStatus::Match;
-                                }
-                            }
-                            if (result == ParseStatus::Match)
-                            {
-                                _parsed_argument = std::string_view(**argv);
-                                (*argc)--;
-                                (*argv)++;
-                                _parsed_count++;
-                            }
-                        }
-                    }
-                    else
-                    {
-                        auto iter = std::find(_pattern.begin(), _pattern.end(), '*');
-                        auto count_beg = std::distance(_pattern.begin(), iter);
-                        auto count_end = std::distance(iter + 1, _pattern.end());
-                        auto len = std::strlen(**argv);
-                        bool cmp1 = std::strncmp(&_pattern[0], (**argv) + 2, count_beg) == 0;
-                        bool cmp2 = true;
-                        for (ptrdiff_t i = 0; i < count_end; i++)
-                        {
-                            if (*(iter + 1 + i) != *((**argv) + len - count_end + i))
-                            {
-                                cmp2 = false;
-                                break;
-                            }
-                        }
-                        if (cmp1 && cmp2)
-                        {
-                            auto begin = (**argv) + count_beg + 2;
-                            auto end = (**argv) + len - count_end;
-                            auto iter = std::find(begin, end, '=');
-                            _parsed_argument = std::string_view(**argv);
-                            _parsed_pattern_argument = std::string_view(begin, iter - begin);
-                            (*argc)--;
-                            (*argv)++;
-                            _parsed_count++;
-                            result = ParseStatus::Match;
-                        }
-                    }
-                }
-                return result;
+                _main_group.register_option(bo);
             }
-            std::string_view
-                long_name() const
+            void set_main_group_help_option(base_option* help)
             {
-                return _long_name;
+                _main_group.set_help_option(help);
             }
-            char
-                short_name() const
+            void
+                register_sub_program(base_sub_program* sp)
             {
-                return _short_name;
+                _sub_programs.push_back(sp);
             }
-            std::string_view
-                name() const
+            base_group*
+                get_main_group()
             {
-                return _long_name == "" ? std::string_view(&_short_name) : _long_name;
+                return &_main_group;
             }
-            template <class T>
-            std::string
-                get_print_name_argument(std::optional<T> def) const
+            // Options of the schema in id order, starting with the main group
+            std::span<base_option* const>
+                options() const
             {
-                std::string name_ = "";
-                if (short_name() != 0)
-                {
-                    name_ += "-";
-                    name_.push_back(short_name());
-                    if (long_name() != "")
-                    {
-                        name_ += " | --" + std::string(long_name());
-                    }
-                }
-                else
+                freeze();
+                return _options;
+            }
+            // Bytes of the parser, its tables and its sub programs. The main group is an option and the default
+            // result is only allocated by a parse, both aren't included
+            std::size_t
+                footprint() const
+            {
+                freeze();
+                std::size_t result = sizeof(*this) - sizeof(_main_group) + _options.capacity() * sizeof(base_option*)
+                    + _states.capacity() * sizeof(parse_state) + _state_of.capacity() * sizeof(std::uint32_t);
+                for (const auto& c : _conflicts)
                 {
-                    name_ += "--" + std::string(long_name());
+                    result += sizeof(c) + helper::heap_size(c.token);
                 }
-                std::string argn(arg_name());
-                if (argn == "")
+                for (const auto* sp : _sub_programs)
                 {
-                    argn = "arg";
+                    result += sp->object_size();
                 }
-                if (def)
+                return result;
+            }
+            // Candidates for args[cursor] (an empty word if cursor is args.size()), args[0] being the program name.
+            // Only the words before the cursor are parsed into pr, nothing is validated or notified and no help is
+            // rendered. The candidates are looked up by prefix in the sorted name tables of the groups
+            void
+                complete(std::span<const std::string_view> args, std::size_t cursor, parse_result& pr,
+                    std::vector<completion>& candidates) const
+            {
+                freeze();
+                pr.reset();
+                candidates.clear();
+                if (cursor == 0 || cursor > args.size())
                 {
-                    if constexpr (std::is_same_v<T, char>)
-                    {
-                        name_ += " <" + argn + "=";
-                        name_.push_back(*def);
-                        name_ += ">";
-                    }
-                    else if constexpr (std::is_same_v<T, std::string>)
-                    {
-                        name_ += " <" + argn + "=" + *def + ">";
-                    }
-                    else
-                    {
-                        name_ += " <" + argn + "=" + std::to_string(*def) + ">";
-                    }
+                    return;
                 }
-                else
+                for (std::size_t i = 1; i < cursor; i++)
                 {
-                    name_ += " <" + argn + ">";
+                    pr.tokens().push_back(token::classify(args[i]));
                 }
-                return name_;
+                pr.set_program_name(args[0]);
+                completion_request request{cursor < args.size() ? args[cursor] : std::string_view(), candidates};
+                token_stream ts(pr.tokens(), args[0]);
+                run(ts, pr, &request);
             }
-            std::string
-                get_print_name_positional() const
+            std::vector<completion>
+                complete(std::span<const std::string_view> args, std::size_t cursor) const
             {
-                return "<" + std::string(arg_name()) + ">...";
+                auto pr = make_result();
+                std::vector<completion> result;
+                complete(args, cursor, pr, result);
+                return result;
             }
+            // Called as "program --complete-args word... partial", prints the candidates for the last argument one
+            // per line and returns true, otherwise returns false. Positionals are left to the shell. This is how
+            // the scripts in the completion folder ask the program
             bool
-                parsed() const
+                try_complete_command_line(int argc, const char** argv, std::ostream& out) const
             {
-                return _parsed_argument != "";
+                if (argc < 2 || std::string_view(argv[1]) != "--complete-args")
+                {
+                    return false;
+                }
+                freeze();
+                std::vector<std::string_view> args{argv[0]};
+                args.insert(args.end(), argv + 2, argv + argc);
+                std::vector<completion> candidates;
+                complete(args, args.size() - 1, *_result, candidates);
+                for (const auto& c : candidates)
+                {
+                    if (c.kind != CompletionKind::Positional)
+                    {
+                        out << c.text << '\n';
+                    }
+                }
+                return true;
             }
-            bool
-                parsed_as_group() const
+            // Tokens options or groups of the same group compete for. Found when the schema is frozen, every parse
+            // of a schema with fatal conflicts throws
+            const std::vector<conflict>&
+                conflicts() const
             {
-                return _parsed_argument.size() > 0 && _parsed_argument[0] != '-';
+                compile_once();
+                return _conflicts;
             }
-            std::string_view
-                parsed_argument() const
+            // Every parse function has a try_ variant, which doesn't throw on bad input but returns the status or the
+            // error. A help option ends the parse with HelpParsed, its text is read with help_text. The variants
+            // without try_ throw help_ex or std::runtime_error instead
+            ParseStatus
+                parse_command_line(int argc, const char** argv)
             {
-                return _parsed_argument;
+                return raise(try_parse_command_line(argc, argv), *_result);
             }
-            std::size_t
-                parsed_count() const
+            outcome
+                try_parse_command_line(int argc, const char** argv)
             {
-                return _parsed_count;
+                freeze();
+                _argc = argc;
+                _argv = argv;
+                _result->reset();
+                return parse_arguments(argc > 0 ? argv[0] : "", [argc, argv, i = 1](token& t) mutable
+                    {
+                        bool result = i < argc;
+                        if (result)
+                        {
+                            t = token::classify(argv[i++]);
+                        }
+                        return result;
+                    }, *_result);
             }
-            void
-                set_parsed_argument(std::string_view parsed_argument)
+            // Same as parse_command_line(argc, argv) for tokens not coming from main, args[0] is the program name
+            ParseStatus
+                parse_command_line(std::span<const std::string_view> args)
             {
-                _parsed_argument = parsed_argument;
+                return raise(try_parse_command_line(args), *_result);
             }
-            std::string_view
-                parsed_pattern_argument() const
+            outcome
+                try_parse_command_line(std::span<const std::string_view> args)
             {
-                return _parsed_pattern_argument;
+                freeze();
+                _argc = 0;
+                _argv = nullptr;
+                return try_parse(args, *_result);
             }
-            void inc_parsed_count()
+            // Parses args into pr without touching the parser or the options, so it can be called concurrently,
+            // pr has to be created by make_result of this parser and is reset before parsing
+            ParseStatus
+                parse(std::span<const std::string_view> args, parse_result& pr) const
             {
-                _parsed_count++;
+                return raise(try_parse(args, pr), pr);
             }
-            std::string_view
-                desc() const
+            outcome
+                try_parse(std::span<const std::string_view> args, parse_result& pr) const
             {
-                return _desc;
+                freeze();
+                pr.reset();
+                return parse_arguments(args.empty() ? "" : args[0], [args, i = std::size_t(1)](token& t) mutable
+                    {
+                        bool result = i < args.size();
+                        if (result)
+                        {
+                            t = token::classify(args[i++]);
+                        }
+                        return result;
+                    }, pr);
             }
-            std::string_view
-                arg_name() const
+            // Parses the buffer pr.input() in place, no argument is copied
+            ParseStatus
+                parse_input(parse_result& pr) const
             {
-                return _arg_name;
+                return raise(try_parse_input(pr), pr);
             }
-            parent_t
-                parent()
+            outcome
+                try_parse_input(parse_result& pr) const
             {
-                return _parent;
+                freeze();
+                pr.reset();
+                std::string_view input = pr.input();
+                auto next = [&input]
+                {
+                    auto end = std::min(input.find('\0'), input.size());
+                    auto result = input.substr(0, end);
+                    input.remove_prefix(std::min(end + 1, input.size()));
+                    return result;
+                };
+                std::string_view program_name = next();
+                return parse_arguments(program_name, [&input, next](token& t)
+                    {
+                        bool result = !input.empty();
+                        if (result)
+                        {
+                            t = token::classify(next());
+                        }
+                        return result;
+                    }, pr);
             }
-            const parent_t
-                parent() const
+            // Parses a single command line, quoted and escaped like for a POSIX shell, the first word is the program
+            // name
+            ParseStatus
+                parse_line(std::string_view line, parse_result& pr) const
             {
-                return _parent;
+                return raise(try_parse_line(line, pr), pr);
             }
-            virtual void
-                notify() const = 0;
-            virtual void
-                print_help(std::ostream& os, int argc, const char** argv) const = 0;
-
-        private:
-            parent_t _parent;
-            char _short_name;
-            std::string_view _long_name;
-            std::string_view _pattern;
-            std::string_view _parsed_argument;
-            std::string_view _parsed_pattern_argument;
-            std::string_view _desc;
-            std::string_view _arg_name;
-            std::size_t _parsed_count{0};
-        };
-        class base_group
-            : public base_option
-        {
-        public:
-            using base1_t = base_option;
-
-            base_group(
-                  parent_t parent
-                , std::string_view name
-                , char short_name
-                , bool optional
-                , std::string_view desc)
-
-                : base1_t(parent, name, short_name, "", desc, "")
-                , _optional(optional)
-            {}
-            void
-                register_option(base_option* bo)
+            outcome
+                try_parse_line(std::string_view line, parse_result& pr) const
             {
-                _options.push_back(bo);
+                auto e = pr.assign_line(line);
+                if (e)
+                {
+                    freeze();
+                    pr.reset();
+                    pr.fail(e);
+                    return e;
+                }
+                return try_parse_input(pr);
             }
-            void
-                register_group(base_group* bg)
+            ParseStatus
+                parse_line(std::string_view line)
             {
-                _groups.push_back(bg);
+                return raise(try_parse_line(line), *_result);
             }
-            void 
-                set_multi_positional_argument(base_option* bo)
+            outcome
+                try_parse_line(std::string_view line)
             {
-                _multi_positional_argument = bo;
+                freeze();
+                _argc = 0;
+                _argv = nullptr;
+                return try_parse_line(line, *_result);
             }
-            base_option*
-                get_multi_positional_argument()
+            // Help of the group whose help option ended the parse into pr
+            std::string
+                help_text(const parse_result& pr) const
             {
-                return _multi_positional_argument;
+                return pr.help_group() != nullptr ? pr.help_group()->help_text(pr.program_name()) : std::string();
             }
-            const base_option*
-                get_multi_positional_argument() const
+            std::string
+                help_text() const
             {
-                return _multi_positional_argument;
+                freeze();
+                return help_text(*_result);
             }
-            void
-                set_help_option(base_option* help)
+            parse_result
+                parse(std::span<const std::string_view> args) const
             {
-                if (_help != nullptr)
-                {
-                    throw std::runtime_error("po error: tryed to set help for \"" + std::string(name()) + "\" twice");
-                }
-                _help = help;
+                auto result = make_result();
+                parse(args, result);
+                return result;
             }
-            void
-                set_sub_program(base_sub_program* sp)
+            // Empty result with a slot for every option of the schema, can be reused for any number of parses
+            parse_result
+                make_result() const
             {
-                if (_sub_program != nullptr)
-                {
-                    throw std::runtime_error("po error: tryed to set sub program for \"" + std::string(name()) + "\" twice");
-                }
-                _sub_program = sp;
+                return make_result(_resource);
             }
-            void
-                set_after(base_option* bo)
+            parse_result
+                make_result(std::pmr::memory_resource* mr) const
             {
-                _after = bo;
+                freeze();
+                return create_result(parse_result(mr));
             }
-            void
-                set_bind_to(base_option* bo)
+            // Same as make_result, but the result allocates from its own monotonic arena of size bytes
+            parse_result
+                make_arena_result(std::size_t size = 4096) const
             {
-                _bind_to = bo;
+                freeze();
+                return create_result(parse_result(std::make_unique<detail::arena>(size)));
             }
-            virtual ParseStatus
-                try_parse_option(int narg, int* argc, const char*** argv) override
+            // Parses and checks every line of lines like try_parse, try_validate and try_notify would. lines is a random
+            // access range of argument lists, each starting with the program name. The lines are split into threads
+            // shares (one per thread of the worker_pool if 0), which run on the worker_pool, every worker parsing
+            // into its own arena result, from which the values are copied into the columns of the batch. Lines are
+            // handed out in blocks of 64, a worker done with its share steals blocks from the shares of the
+            // others. A batch of a single block, or a single share, is parsed on the calling thread. Response files
+            // aren't expanded, string_view values and errors point into lines
+            template <class Lines>
+            batch_result
+                parse_batch(const Lines& lines, std::size_t threads = 0) const
             {
-                auto result = base1_t::try_parse_option(narg, argc, argv);
-                if (result == ParseStatus::Match)
+                freeze();
+                std::size_t count = std::size(lines);
+                std::size_t blocks = (count + 63) / 64;
+                auto& pool = worker_pool::instance();
+                threads = std::clamp<std::size_t>(threads != 0 ? threads : pool.size(), 1, std::max<std::size_t>(blocks, 1));
+                batch_result result(count, *_result, _options.size(), threads);
+                struct share
+                {
+                    std::atomic<std::size_t> next{0};
+                    std::size_t end{0};
+                };
+                std::vector<share> shares(threads);
+                for (std::size_t t = 0; t < threads; t++)
+                {
+                    shares[t].next = blocks * t / threads;
+                    shares[t].end = blocks * (t + 1) / threads;
+                }
+                auto work = [&](std::size_t t)
                 {
-                    if (parsed_as_group())
+                    auto pr = make_arena_result(1 << 16);
+                    for (std::size_t v = 0; v < threads; v++)
                     {
-                        bool parsed = true;
-                        bool group_parsed = false;
-                        std::size_t parsed_counter = 0;
-                        while (parsed)
+                        auto& sh = shares[(t + v) % threads];
+                        for (auto b = sh.next++; b < sh.end; b = sh.next++)
                         {
-                            parsed = false;
-                            for (auto* op : options())
-                            {
-                                auto ret = op->try_parse_option(narg, argc, argv);
-                                if (ret == ParseStatus::Match)
-                                {
-                                    if (!op->parsed_as_group() && *argc != 0)
-                                    {
-                                        parsed = true;
-                                    }
-                                    parsed_counter++;
-                                    break;
-                                }
-                                else if (ret == ParseStatus::HelpParsed)
-                                {
-                                    parsed= false;
-                                    result = ret;
-                                    break;
-                                }
-                            }
-                            if (!parsed)
+                            for (std::size_t i = b * 64; i < std::min(count, b * 64 + 64); i++)
                             {
-                                for (auto* op : groups())
-                                {
-                                    result = op->try_parse_option(narg, argc, argv);
-                                    if (*argc == 0)
-                                    {
-                                        break;
-                                    }
-                                    if (result == ParseStatus::Match)
-                                    {
-                                        break;
-                                    }
-                                    else if (result == ParseStatus::HelpParsed)
-                                    {
-                                        break;
-                                    }
-                                }
+                                parse_batch_line(lines[i], i, pr, result, t);
                             }
                         }
-                        if (_bind_to != nullptr)
-                        {
-                            _bind_to->try_parse_option(narg, argc, argv);
-                        }
-                        if (_multi_positional_argument != nullptr)
-                        {
-                            _multi_positional_argument->try_parse_option(narg, argc, argv);
-                        }
-                    }
-                    else
-                    {
-                        (*argc)++;
-                        (*argv)--;
-                        result = ParseStatus::NoMatch;
                     }
+                };
+                pool.run(threads, work);
+                return result;
+            }
+            // With response files enabled an argument @file is replaced by the arguments inside file, separated by
+            // whitespace or '\0'. The file is mapped into memory and its arguments point into the mapping, which is
+            // owned by the parse_result. Response files can include further response files. Has to be set before
+            // the first parse
+            void
+                set_response_files(bool enabled)
+            {
+                if (_result)
+                {
+                    throw std::runtime_error("po error: response files enabled after the first parse");
                 }
-                if (_after != nullptr)
+                _response_files = enabled;
+            }
+            // Resource used by the result of parse_command_line and by make_result(), has to be set before the
+            // first parse
+            void
+                set_memory_resource(std::pmr::memory_resource* mr)
+            {
+                if (_result)
                 {
-                    _after->try_parse_option(narg, argc, argv);
+                    throw std::runtime_error("po error: memory resource set after the first parse");
                 }
-                return result;
+                _resource = mr;
+            }
+            // Sink for the trace events of parse_command_line, results of make_result take their own
+            void
+                set_trace_sink(trace_sink* sink)
+            {
+                freeze();
+                _result->set_trace_sink(sink);
+            }
+            // Forgets everything parse_command_line parsed so far, containers keep their capacity
+            void
+                reset()
+            {
+                freeze();
+                _result->reset();
+            }
+            void
+                notify() const
+            {
+                freeze();
+                notify(*_result);
             }
-            std::optional<int>
-                execute_main()
+            void
+                notify(const parse_result& pr) const
             {
-                std::optional<int> result = std::nullopt;
-                if (_sub_program != nullptr)
-                {
-                    result = (*_sub_program)();
-                }
-                return result;
+                _main_group.notify(pr);
             }
-            const std::vector<base_option*>&
-                options() const
+            po::error
+                try_notify() const
             {
-                return _options;
+                freeze();
+                return try_notify(*_result);
             }
-            const std::vector<base_group*>&
-                groups() const
+            po::error
+                try_notify(const parse_result& pr) const
             {
-                return _groups;
+                return _main_group.check(pr);
             }
-            bool
-                optional() const
+            void
+                validate()
             {
-                return _optional;
+                freeze();
+                _result->validate();
             }
-            bool
-                help_parsed() const
+            po::error
+                try_validate()
             {
-                bool result = false;
-                if (_help != nullptr)
+                freeze();
+                return _result->try_validate();
+            }
+            operator base_group&()
+            {
+                return _main_group;
+            }
+            std::optional<int>
+                execute_main() const
+            {
+                freeze();
+                return execute_main(*_result);
+            }
+            std::optional<int>
+                execute_main(const parse_result& pr) const
+            {
+                std::optional<int> result;
+                for (auto* sp : _sub_programs)
                 {
-                    result = _help->parsed();
+                    if (sp->parsed(pr))
+                    {
+                        result = (*sp)(pr);
+                        if (*result != 0)
+                        {
+                            break;
+                        }
+                    }
                 }
                 return result;
             }
-            base_option*
-                after()
+            const parse_result&
+                result() const
             {
-                return _after;
+                freeze();
+                return *_result;
             }
-            const base_option*
-                after() const
+            int get_argc() const
             {
-                return _after;
+                return _argc;
             }
-            base_option*
-                bind_to()
+            const char** get_argv() const
             {
-                return _bind_to;
+                return _argv;
             }
-            const base_option*
-                bind_to() const
+
+        private:
+            // Assigns the ids of all options once, after that the schema can no longer be changed. A schema with
+            // fatal conflicts can't be parsed with, it throws naming the first one and its options, or their patterns
+            void
+                freeze() const
             {
-                return _bind_to;
+                compile_once();
+                auto first = std::find_if(_conflicts.begin(), _conflicts.end(), [](const conflict& c) { return c.fatal; });
+                if (first != _conflicts.end())
+                {
+                    auto name = [](const base_option* bo) { return std::string(bo->pattern() != "" ? bo->pattern() : bo->name()); };
+                    throw std::runtime_error("po error: \"" + first->token + "\" is used by \"" + name(first->taken)
+                        + "\" and \"" + name(first->shadowed) + "\"");
+                }
             }
-            virtual void
-                notify() const override
+            void
+                compile_once() const
             {
-                bool result = false;
-                if (!optional() && !parsed())
+                std::call_once(_frozen, [this]
+                    {
+                        _main_group.freeze(_options);
+                        compile();
+                        _result.emplace(create_result(parse_result(_resource)));
+                        for (auto* op : _options)
+                        {
+                            op->set_default_result(&*_result);
+                            _streaming = _streaming || op->streams();
+                        }
+                    });
+            }
+            parse_result
+                create_result(parse_result result) const
+            {
+                for (const auto* op : _options)
                 {
-                    throw std::runtime_error("po error: could not find option \"" + std::string(name()) + "\"");
+                    result.add_option(op->captures_count(), op->create_value(result.resource()));
                 }
-                if (parsed())
+                return result;
+            }
+            // Reads the arguments next returns one at a time. With response files enabled an argument @file is
+            // replaced by the arguments inside file, separated by '\0' if the file contains any, otherwise by
+            // whitespace. Relative paths of nested response files are relative to the including file
+            template <class Next>
+            class argument_source final
+                : public token_source
+            {
+            public:
+                argument_source(Next next, bool response_files, parse_result& pr)
+                    : _next(std::move(next))
+                    , _response_files(response_files)
+                    , _pr(pr)
+                {}
+                virtual bool
+                    next() override
                 {
-                    for (const auto* op : options())
-                    {
-                        op->notify();
-                    }
-                    if (_bind_to != nullptr)
+                    bool result = false;
+                    bool more = true;
+                    while (!result && more && !_pr.stopped())
                     {
-                        if (!_bind_to->parsed())
+                        token t;
+                        if (!_files.empty())
+                        {
+                            more = read(_files.back(), t);
+                        }
+                        else
+                        {
+                            more = _next(t);
+                        }
+                        if (!more && !_files.empty())
+                        {
+                            _files.pop_back();
+                            more = true;
+                        }
+                        else if (more && _response_files && t.kind == TokenKind::Word && t.size > 1 && t.data[0] == '@')
+                        {
+                            std::string_view path = t.text().substr(1);
+                            open(_files.empty() ? std::filesystem::path(path) : _files.back().path.parent_path() / path);
+                        }
+                        else if (more)
                         {
-                            throw std::runtime_error("po error: if \"" + std::string(name()) + "\" is given, \"" +
-                                std::string(_bind_to->name()) + "\" must follow");
+                            _pr.tokens().push_back(t);
+                            result = true;
                         }
-                        _bind_to->notify();
                     }
+                    return result;
                 }
-                if (_after != nullptr)
+
+            private:
+                struct open_file
+                {
+                    const mapped_file* file;
+                    std::filesystem::path path;
+                    std::size_t pos;
+                    bool nul_separated;
+                };
+
+                void
+                    open(std::filesystem::path path)
                 {
-                    if (!_after->parsed())
+                    const auto* file = _pr.add_file(path.string());
+                    if (file != nullptr)
                     {
-                        throw std::runtime_error("po error: could not find \"" + std::string(_after->name()) + "\"");
+                        if (std::any_of(_files.begin(), _files.end(), [file](const open_file& f) { return f.file->id() == file->id(); }))
+                        {
+                            _pr.fail(po::error::file(ErrorCode::ResponseFileLoop, path.string()));
+                        }
+                        else
+                        {
+                            _files.push_back({file, std::move(path), 0, file->data().find('\0') != std::string_view::npos});
+                        }
                     }
-                    _after->notify();
                 }
-            }
-            virtual void
-                print_help(std::ostream& os, int argc, const char** argv) const override
-            {
-                // Synopsis
-                os << "Synopsis:\n";
-                os << "  ";
-                std::filesystem::path path_to_exe(*argv);
-                os << path_to_exe.filename().string() << " ";
-                std::vector<cparent_t> hist;
+                // Next argument of f, false at its end
+                static bool
+                    read(open_file& f, token& t)
                 {
-                    cparent_t cur = *this;
-                    while (cur)
+                    auto data = f.file->data();
+                    auto is_separator = [&f](char c)
                     {
-                        hist.push_back(cur);
-                        cur = cur->get().parent();
+                        return c == 0 || (!f.nul_separated && std::isspace(static_cast<unsigned char>(c)));
+                    };
+                    while (f.pos != data.size() && is_separator(data[f.pos]))
+                    {
+                        f.pos++;
                     }
-                }
-                for (auto iter = hist.rbegin(); iter != hist.rend() - 1; iter++)
-                {
-                    const base_group& bg = (**iter).get();
-                    if (bg.name() != "")
+                    std::size_t begin = f.pos;
+                    while (f.pos != data.size() && !is_separator(data[f.pos]))
                     {
-                        os << bg.name() << " ";
+                        f.pos++;
                     }
-                    if (bg.options().size() > 0)
+                    if (f.pos != begin)
                     {
-                        os << "[Options...] ";
+                        t = token::classify(data.substr(begin, f.pos - begin));
                     }
+                    return f.pos != begin;
                 }
-                if (options().size() > 0)
-                {
-                    os << "[Options...] ";
-                }
-                if (groups().size() > 0)
-                {
-                    os << "[SubGroup] ";
-                }
-                base_option* cur = nullptr;
-                bool b_to = false;
-                if (_after != nullptr)
-                {
-                    cur = _after;
-                }
-                else if (_bind_to != nullptr)
+
+                Next _next;
+                bool _response_files;
+                parse_result& _pr;
+                std::vector<open_file> _files;
+            };
+
+            // Parses the arguments next returns, next(token&) classifies the next argument into the token and
+            // returns false at the end. The tokens are read during the parse if an option streams its arguments,
+            // otherwise all of them are read before
+            template <class Next>
+            outcome
+                parse_arguments(std::string_view program_name, Next next, parse_result& pr) const
+            {
+                argument_source<Next> source(std::move(next), _response_files, pr);
+                if (!_streaming)
                 {
-                    cur = _bind_to;
+                    while (source.next())
+                    {
+                    }
                 }
-                while (cur != nullptr)
+                return parse_tokens(program_name, pr, _streaming ? &source : nullptr);
+            }
+            // Numbers the main group, every group reachable from it and their followers (BindTo, positionals and
+            // After) as states of the parse machine, and collects the conflicts of the groups on the way
+            void
+                compile() const
+            {
+                _states.clear();
+                _state_of.assign(_options.size(), parse_state::none);
+                _conflicts.clear();
+                auto state_of = [this](const base_option* bo)
                 {
-                    auto* bg_cur = dynamic_cast<base_group*>(cur);
-                    if (bg_cur->optional() && !b_to)
+                    if (bo == nullptr)
                     {
-                        os << "[";
-                        b_to = true;
+                        return parse_state::none;
                     }
-                    std::string name_{cur->long_name()};
-                    os << name_ << " ";
-                    if (bg_cur->bind_to() == nullptr && b_to)
+                    auto& index = _state_of[bo->id()];
+                    if (index == parse_state::none)
                     {
-                        os << "] ";
-                        b_to = false;
+                        index = static_cast<std::uint32_t>(_states.size());
+                        _states.push_back({bo});
                     }
-                    if (bg_cur != nullptr)
+                    return index;
+                };
+                state_of(&_main_group);
+                for (std::size_t i = 0; i < _states.size(); i++)
+                {
+                    parse_state s{_states[i].option, _states[i].option->as_group()};
+                    if (s.group != nullptr)
                     {
-                        cur = nullptr;
-                        if (bg_cur->after() != nullptr)
-                        {
-                            cur = bg_cur->after();
-                        }
-                        else if (bg_cur->bind_to() != nullptr)
+                        s.kind = i == 0 ? parse_state::Kind::Root
+                            : s.option->positional() ? parse_state::Kind::Positional : parse_state::Kind::Group;
+                        s.bind_to = state_of(s.group->bind_to());
+                        s.positionals = state_of(s.group->get_multi_positional_argument());
+                        s.after = state_of(s.group->after());
+                        for (const auto* bg : s.group->groups())
                         {
-                            cur = bg_cur->bind_to();
+                            state_of(bg);
                         }
+                        s.group->find_conflicts(_conflicts);
                     }
+                    _states[i] = s;
                 }
-                if (get_multi_positional_argument() != nullptr)
-                {
-                    os << get_multi_positional_argument()->get_print_name_positional();
-                }
-                os << "\n\n";
-                if (desc() != "")
+            }
+            // Runs the parse machine: the state on top of the stack looks the next token up in its tables and
+            // either consumes it, pushes the state of a subgroup or follower, or returns to the state below. Only
+            // HelpParsed and Error end the parse early, the result of a follower is dropped otherwise
+            ParseStatus
+                run(token_stream& ts, parse_result& pr, completion_request* request = nullptr) const
+            {
+                using Phase = parse_frame::Phase;
+                using Kind = parse_state::Kind;
+                auto& stack = pr.frames();
+                stack.clear();
+                stack.push_back({0});
+                ParseStatus returned = ParseStatus::NoMatch;
+                auto push = [&](std::uint32_t state)
                 {
-                    os << desc();
-                    os << "\n\n";
-                }
-                if (groups().size() > 0)
+                    trace(pr, [&] { return trace_event{TraceKind::Follow, ts.position(), _states[state].option, ParseStatus::NoMatch, 0, stack.size()}; });
+                    stack.push_back({state});
+                };
+                // The last follower of a state takes its place on the stack, the state has nothing left to do but
+                // to pass its result on. So long After and BindTo chains don't grow the stack
+                auto replace = [&](parse_frame& f, std::uint32_t state)
                 {
-                    os << "Help:\n";
-                    os << "Type program_name --help for a help overview\n";
-                    os << "and program_name <SubGroup> --help for help on a specifiy SubGroup";
-                    os << "\n\n";
-                }
-                // Synopsis end
-
-                if (options().size() > 0)
+                    auto passed = f.passes_on ? f.passed : f.result;
+                    trace(pr, [&] { return trace_event{TraceKind::Follow, ts.position(), _states[state].option, ParseStatus::NoMatch, 0, stack.size() - 1}; });
+                    f = {state, Phase::Enter, ParseStatus::NoMatch, true, passed};
+                };
+                while (!stack.empty())
                 {
-                    os << "Options:\n";
-                    for (const auto* op : options())
+                    auto& f = stack.back();
+                    const auto& s = _states[f.state];
+                    switch (f.phase)
                     {
-                        op->print_help(os, argc, argv);
-                    }
-                }
-                if (groups().size() > 0)
-                {
-                    os << "\nSubGroups:\n";
-                    for (const auto* g : groups())
+                    case Phase::Enter:
                     {
-                        helper::print_2_columns(os, g->name(), g->desc());
-                        os << "\n\n";
+                        if (s.kind == Kind::Root)
+                        {
+                            f.phase = Phase::RootOptions;
+                            break;
+                        }
+                        // A group is only entered by its name given as a word, --name and -n are left to the
+                        // options of the group it is in
+                        std::size_t token = ts.position();
+                        auto ret = ParseStatus::NoMatch;
+                        if (request != nullptr && ts.empty())
+                        {
+                            complete_state(s, *request);
+                        }
+                        else if (s.kind != Kind::Group || (!ts.empty() && ts.peek().kind == TokenKind::Word &&
+                            ts.peek().size > 0 && ts.peek().data[0] != '-'))
+                        {
+                            ret = s.option->try_parse_option(ts, pr);
+                        }
+                        if (base_group::ends_parse(ret))
+                        {
+                            return ret;
+                        }
+                        if (ret == ParseStatus::Match)
+                        {
+                            trace(pr, [&] { return trace_event{TraceKind::Parsed, token, s.option, ret}; });
+                        }
+                        f.result = ret;
+                        if (s.kind == Kind::Leaf)
+                        {
+                            returned = f.passes_on ? f.passed : f.result;
+                            stack.pop_back();
+                            break;
+                        }
+                        f.phase = Phase::After;
+                        if (ret == ParseStatus::Match && s.kind == Kind::Positional && s.bind_to != parse_state::none)
+                        {
+                            push(s.bind_to);
+                            break;
+                        }
+                        if (ret != ParseStatus::Match || s.kind != Kind::Group)
+                        {
+                            break;
+                        }
+                        f.phase = Phase::Options;
+                        [[fallthrough]];
                     }
-                }
-                if (get_multi_positional_argument() != nullptr)
-                {
-                    get_multi_positional_argument()->print_help(os, argc, argv);
-                }
-            }
-
-        private:
-            std::vector<base_option*> _options;
-            std::vector<base_group*> _groups;
-            base_option* _help;
-            base_sub_program* _sub_program{nullptr};
-            base_option* _after{nullptr};
-            base_option* _bind_to{nullptr};
-            base_option* _multi_positional_argument{nullptr};
-            bool _optional;
-            bool _has_group{false};
-        };
-        class root_group
-            : public base_group
-        {
-        public:
-            using base1_t = base_group;
-
-            root_group()
-                : base_group(std::nullopt, "", 0, false, "")
-            {
-                set_parsed_argument("main_group");
-            }
-            virtual ParseStatus
-                try_parse_option(int narg, int* argc, const char*** argv) override
-            {
-                ParseStatus result = ParseStatus::NoMatch;
-                if (*argc != 0)
-                {
-                    bool parsed = true;
-                    while (parsed)
+                    case Phase::Options:
                     {
-                        parsed = false;
-                        for (auto* op : options())
+                        if (ts.empty())
                         {
-                            result = op->try_parse_option(narg, argc, argv);
-                            if (*argc == 0)
+                            if (request != nullptr && !request->words_taken)
                             {
-                                break;
+                                s.group->complete_options(request->word, request->candidates);
+                                s.group->complete_groups(request->word, request->candidates);
+                            }
+                        }
+                        else
+                        {
+                            auto found = s.group->lookup(ts, pr);
+                            auto ret = base_group::try_parse_found(found.option, ts, pr);
+                            if (base_group::ends_parse(ret))
+                            {
+                                return ret;
                             }
-                            if (result == ParseStatus::Match)
+                            if (ret == ParseStatus::Match && !found.option->parsed_as_group(pr))
                             {
-                                parsed = true;
                                 break;
                             }
-                            else if (result == ParseStatus::HelpParsed)
+                            // An option given as a word ends the options of the group, the next token may start a
+                            // subgroup
+                            if (ret == ParseStatus::Match && !ts.empty() && !s.group->groups().empty())
                             {
-                                break;
+                                found = s.group->lookup(ts, pr);
                             }
-                        }
-                        if (!parsed)
-                        {
-                            for (auto* op : groups())
+                            if (!ts.empty() && !s.group->groups().empty())
                             {
-                                result = op->try_parse_option(narg, argc, argv);
-                                if (*argc == 0)
-                                {
-                                    break;
-                                }
-                                if (result == ParseStatus::Match)
-                                {
-                                    break;
-                                }
-                                else if (result == ParseStatus::HelpParsed)
+                                f.result = f.sub_group ? f.result : ParseStatus::NoMatch;
+                                if (found.group != nullptr)
                                 {
+                                    f.phase = Phase::SubGroup;
+                                    stack.push_back({_state_of[found.group->id()]});
                                     break;
                                 }
                             }
+                            else if (ts.empty() && request != nullptr && !request->words_taken)
+                            {
+                                s.group->complete_groups(request->word, request->candidates);
+                            }
                         }
+                        [[fallthrough]];
                     }
-                    if (get_multi_positional_argument() != nullptr)
+                    case Phase::BindTo:
+                        if (s.bind_to != parse_state::none && s.positionals == parse_state::none && s.after == parse_state::none)
+                        {
+                            replace(f, s.bind_to);
+                            break;
+                        }
+                        if (s.bind_to != parse_state::none)
+                        {
+                            f.phase = Phase::Positionals;
+                            push(s.bind_to);
+                            break;
+                        }
+                        [[fallthrough]];
+                    case Phase::Positionals:
+                        if (s.positionals != parse_state::none && s.after == parse_state::none)
+                        {
+                            replace(f, s.positionals);
+                            break;
+                        }
+                        if (s.positionals != parse_state::none)
+                        {
+                            f.phase = Phase::After;
+                            push(s.positionals);
+                            break;
+                        }
+                        [[fallthrough]];
+                    case Phase::After:
+                        if (s.after != parse_state::none)
+                        {
+                            replace(f, s.after);
+                        }
+                        else
+                        {
+                            returned = f.passes_on ? f.passed : f.result;
+                            stack.pop_back();
+                        }
+                        break;
+                    // The options of a group are matched again after its subgroup, so options of enclosing groups and
+                    // sibling subgroups can follow a subgroup
+                    case Phase::SubGroup:
+                        f.result = returned;
+                        f.sub_group = returned == ParseStatus::Match;
+                        f.phase = ts.empty() ? Phase::BindTo : Phase::Options;
+                        break;
+                    case Phase::RootOptions:
                     {
-                        result = get_multi_positional_argument()->try_parse_option(narg, argc, argv);
-                    }
-                }
-                return result;
-            }
-        };
-        class parser
-        {
-        public:
-            static parser& instance()
-            {
-                return _instance;
-            }
-
-            parser()
-                : _main_group(std::make_unique<root_group>())
-            {}
-            void
-                register_main_group_option(base_option* bo)
-            {
-                _main_group->register_option(bo);
-            }
-            void set_main_group_help_option(base_option* help)
-            {
-                _main_group->set_help_option(help);
-            }
-            void
-                register_sub_program(base_sub_program* sp)
-            {
-                _sub_programs.push_back(sp);
+                        if (ts.empty())
+                        {
+                            if (request != nullptr)
+                            {
+                                s.group->complete_options(request->word, request->candidates);
+                                s.group->complete_groups(request->word, request->candidates);
+                            }
+                            f.phase = Phase::RootPositionals;
+                            break;
+                        }
+                        auto found = s.group->lookup(ts, pr);
+                        f.result = base_group::try_parse_found(found.option, ts, pr);
+                        if (base_group::ends_parse(f.result))
+                        {
+                            return f.result;
+                        }
+                        if (f.result == ParseStatus::Match)
+                        {
+                            break;
+                        }
+                        f.phase = Phase::RootPositionals;
+                        if (f.result == ParseStatus::NoMatch && found.group != nullptr)
+                        {
+                            f.phase = Phase::RootSubGroup;
+                            stack.push_back({_state_of[found.group->id()]});
+                        }
+                        break;
+                    }
+                    case Phase::RootSubGroup:
+                        f.result = returned;
+                        f.phase = ts.empty() ? Phase::RootPositionals : Phase::RootOptions;
+                        break;
+                    case Phase::RootPositionals:
+                        if (s.positionals != parse_state::none && (!ts.empty() || request != nullptr))
+                        {
+                            f.phase = Phase::RootPositionalsReturn;
+                            push(s.positionals);
+                        }
+                        else
+                        {
+                            return f.result;
+                        }
+                        break;
+                    case Phase::RootPositionalsReturn:
+                        return returned;
+                    }
+                }
+                return returned;
             }
-            base_group*
-                get_main_group()
+            // Offers the name of a group or the slot of a positional the machine reached without a word left
+            static void
+                complete_state(const parse_state& s, completion_request& request)
             {
-                return _main_group.get();
+                if (request.words_taken)
+                {
+                    return;
+                }
+                if (s.kind == parse_state::Kind::Group)
+                {
+                    if (s.option->long_name() != "" && s.option->long_name().starts_with(request.word))
+                    {
+                        request.candidates.push_back({CompletionKind::Group, std::string(s.option->long_name()), s.option});
+                    }
+                }
+                else
+                {
+                    request.candidates.push_back({CompletionKind::Positional, std::string(s.option->name()), s.option});
+                    request.words_taken = true;
+                }
             }
-            ParseStatus
-                parse_command_line(int argc, const char** argv)
+            outcome
+                parse_tokens(std::string_view program_name, parse_result& pr, token_source* source = nullptr) const
             {
-                _argc = argc;
-                _argv = argv;
                 ParseStatus result = ParseStatus::NoMatch;
-                argc--;
-                argv++;
-                if (argc != 0)
+                pr.set_program_name(program_name);
+                _main_group.set_parsed_argument(pr, "main_group");
+                token_stream ts(pr.tokens(), program_name, source);
+                trace(pr, [&] { return trace_event{TraceKind::Begin}; });
+                if (!ts.empty() && !pr.stopped())
                 {
-                    result = _main_group->try_parse_option(argc, &argc, &argv);
-                    if (result != ParseStatus::Match &&
-                        result != ParseStatus::HelpParsed)
+                    result = run(ts, pr);
+                    if (!base_group::ends_parse(result) && !ts.empty())
                     {
-                        throw std::runtime_error("po error: unkown argument \"" + std::string(*argv) + "\"");
+                        pr.fail(po::error(ErrorCode::UnknownArgument, ts.position(), {}, ts.peek().text()));
                     }
                 }
-                return result;
+                if (!pr.stopped())
+                {
+                    pr.finish();
+                }
+                auto status = pr.failed() ? ParseStatus::Error : pr.help_group() != nullptr ? ParseStatus::HelpParsed : result;
+                trace(pr, [&] { return trace_event{TraceKind::End, ts.position(), nullptr, status}; });
+                if (pr.failed())
+                {
+                    return pr.error();
+                }
+                return status;
             }
             void
-                notify() const
-            {
-                _main_group->notify();
-            }
-            operator base_group&()
-            {
-                return *_main_group;
-            }
-            std::optional<int>
-                execute_main()
+                parse_batch_line(std::span<const std::string_view> args, std::size_t line, parse_result& pr,
+                    batch_result& batch, std::size_t worker) const
             {
-                std::optional<int> result;
-                for (auto* sp : _sub_programs)
+                pr.reset();
+                pr.tokens().reserve(args.size());
+                for (std::size_t i = 1; i < args.size(); i++)
+                {
+                    pr.tokens().push_back(token::classify(args[i]));
+                }
+                auto o = parse_tokens(args.empty() ? "" : args[0], pr);
+                if (o && o.status() != ParseStatus::HelpParsed)
+                {
+                    auto e = pr.try_validate();
+                    e = e ? e : _main_group.check(pr);
+                    o = e ? outcome(e) : o;
+                }
+                if (o)
                 {
-                    if (sp->parsed())
+                    for (const auto* op : _options)
                     {
-                        result = (*sp)();
-                        if (*result != 0)
+                        if (op->parsed(pr))
                         {
-                            break;
+                            batch.set_value(op->id(), line, pr, worker);
                         }
                     }
                 }
-                return result;
-            }
-            int get_argc() const
-            {
-                return _argc;
+                batch.set_line(line, std::move(o));
             }
-            const char** get_argv() const
+            // The throwing api on top of the try_ functions
+            ParseStatus
+                raise(const outcome& o, const parse_result& pr) const
             {
-                return _argv;
+                if (o.status() == ParseStatus::HelpParsed)
+                {
+                    throw help_ex(help_text(pr));
+                }
+                else if (!o)
+                {
+                    throw std::runtime_error(o.error().message());
+                }
+                return o.status();
             }
 
-        private:
             int _argc{0};
             const char** _argv{nullptr};
             static parser _instance;
-            std::unique_ptr<root_group> _main_group;
-            std::vector<base_sub_program*> _sub_programs;
+            mutable root_group _main_group;
+            intrusive_list<base_sub_program> _sub_programs;
+            mutable std::once_flag _frozen;
+            mutable std::vector<base_option*> _options;
+            std::pmr::memory_resource* _resource{std::pmr::get_default_resource()};
+            bool _response_files{false};
+            mutable bool _streaming{false};
+            mutable std::optional<parse_result> _result;
+            mutable std::vector<parse_state> _states;
+            mutable std::vector<std::uint32_t> _state_of;
+            mutable std::vector<conflict> _conflicts;
         };
         template <class T>
         class base_argument
@@ -908,57 +4775,60 @@ namespace po
                 }
                 bg->get().register_option(this);
             }
-            std::optional<T>
-                try_parse_option_argument(int narg, int* argc, const char*** argv)
+            // Sets value to the converted argument on a Match, a value that doesn't convert is an Error
+            ParseStatus
+                try_parse_option_argument(token_stream& ts, parse_result& pr, std::optional<helper::result_type_t<T>>& value) const
+            {
+                std::string_view text;
+                ParseStatus result = try_parse_option_text(ts, pr, text);
+                if (result == ParseStatus::Match)
+                {
+                    result = convert_argument<T>(text, ts.position() - 1, pr, value);
+                }
+                return result;
+            }
+            // Sets text to the value of the option on a Match, an option without a value is an Error
+            ParseStatus
+                try_parse_option_text(token_stream& ts, parse_result& pr, std::string_view& text) const
             {
-                std::optional<T> result = std::nullopt;
-                auto ret = base1_t::try_parse_option(narg, argc, argv);
-                if (ret == ParseStatus::Match)
+                auto result = base1_t::try_parse_option(ts, pr);
+                if (result == ParseStatus::Match)
                 {
-                    auto pa = parsed_argument();
-                    auto iter = std::find(pa.begin(), pa.end(), '=');
-                    std::string_view str_value;
-                    if (iter != pa.end())
+                    const token& t = ts.last();
+                    if (t.kind == TokenKind::LongWithValue || (t.kind == TokenKind::ShortCluster && t.size > 2))
                     {
-                        auto start = std::distance(pa.begin(), iter) + 1;
-                        auto count = std::distance(iter + 1, pa.end());
-                        str_value = std::string_view(&pa[start], count);
+                        text = t.value();
                     }
-                    else if (pa[1] == '-' || (pa[1] != '-' && pa[2] == 0))
+                    else if (!ts.empty())
                     {
-                        if (*argc != 0)
-                        {
-                            str_value = std::string_view(**argv);
-                            (*argc)--;
-                            (*argv)++;
-                        }
+                        text = ts.peek().text();
+                        ts.advance();
                     }
                     else
                     {
-                        str_value = std::string_view(pa.data() + 2, std::distance(pa.begin() + 2, pa.end()));
+                        pr.fail(po::error(ErrorCode::MissingValue, ts.position() - 1, name()));
+                        result = ParseStatus::Error;
                     }
-                    result = helper::lexical_cast<T>(str_value);
                 }
                 return result;
             }
-            virtual void
-                notify() const override
+            virtual po::error
+                check(const parse_result& pr) const override
             {
-                if (_min > parsed_count())
+                po::error result;
+                if (_min > parsed_count(pr))
                 {
-                    throw std::runtime_error("po error: too less \"" + std::string(name()) +
-                        "\" arguments given (min=" + std::to_string(_min) + ")");
+                    result = po::error(ErrorCode::TooFewArguments, po::error::npos, name(), {}, _min);
                 }
-                else if (_max < parsed_count())
+                else if (_max < parsed_count(pr))
                 {
-                    throw std::runtime_error("po error: too many \"" + std::string(name()) +
-                        "\" arguments given (min=" + std::to_string(_min) + ")");
+                    result = po::error(ErrorCode::TooManyArguments, po::error::npos, name(), {}, _max);
                 }
+                return result;
             }
 
         private:
             std::size_t _min{1}, _max{1};
-            std::size_t _parse_counter{0};
         };
 
         struct TagParentGroup {};
@@ -976,8 +4846,15 @@ namespace po
         struct TagBindTo {};
         struct TagAfter {};
         struct TagArgName {};
+        template <class T>
+        struct TagOnArgument {};
+        struct TagReserve {};
+        struct TagLazy {};
+        struct TagParallel {};
     }
 
+    using detail::helper::lexical_cast;
+
     using ParentGroup = detail::helper::named_type<detail::base_group::parent_t, detail::TagParentGroup>;
     using LongName = detail::helper::named_type<std::string_view, detail::TagLongName>;
     using ShortName = detail::helper::named_type<char, detail::TagShortName>;
@@ -993,13 +4870,11 @@ namespace po
     using BindTo = detail::helper::named_type<detail::base_group::parent_t, detail::TagBindTo>;
     using After = detail::helper::named_type<detail::base_group::parent_t, detail::TagAfter>;
     using ArgName = detail::helper::named_type<std::string_view, detail::TagArgName>;
-
-    class help_ex
-        : public std::runtime_error
-    {
-    public:
-        using std::runtime_error::runtime_error;
-    };
+    template <class T = std::string_view>
+    using OnArgument = detail::helper::named_type<std::function<void(const T&)>, detail::TagOnArgument<T>>;
+    using Reserve = detail::helper::named_type<std::size_t, detail::TagReserve>;
+    using Lazy = detail::helper::named_type<bool, detail::TagLazy>;
+    using Parallel = detail::helper::named_type<std::size_t, detail::TagParallel>;
 
     class flag
         : public detail::base_option
@@ -1028,60 +4903,31 @@ namespace po
             auto pg = detail::helper::pick_option_with_default<ParentGroup>(std::nullopt, args...);
             pg->get().register_option(this);
         }
+        bool
+            get(const parse_result& pr) const
+        {
+            return parsed(pr);
+        }
         operator bool() const
         {
             return parsed();
         }
-        virtual void
-            notify() const override
+        virtual po::error
+            check(const parse_result& pr) const override
         {
-            if (parsed_count() > 1)
-            {
-                throw std::runtime_error("po error: flag \"" + std::string(name()) + "\" is specified more than once");
-            }
+            return parsed_count(pr) > 1 ? po::error(ErrorCode::FlagRepeated, po::error::npos, name()) : po::error();
         }
         virtual void
-            print_help(std::ostream& os, int argc, const char** argv) const override
+            print_help(detail::helper::help_writer& w, std::string_view) const override
         {
-            std::string name_ = "";
-            if (short_name() != 0)
-            {
-                name_ += "-";
-                name_.push_back(short_name());
-                if (long_name() != "")
-                {
-                    name_ += " | --" + std::string(long_name());
-                }
-            }
-            else
-            {
-                name_ += "--" + std::string(long_name());
-            }
-            os << "  ";
-            os << std::setw(26) << std::left << name_;
-            if (name_.size() > 22 && desc() != "")
-            {
-                os << "\n";
-            }
-            std::stringstream desc_{std::string(desc())};
-            std::size_t bytes_written = 0;
-            while (desc_)
-            {
-                std::string word;
-                desc_ >> word;
-                if (bytes_written > 0 && bytes_written + word.size() > 32)
-                {
-                    bytes_written = 0;
-                    os << "\n  " << std::setw(26) << "";
-                }
-                if (word == "")
-                {
-                    break;
-                }
-                os << word << " ";
-                bytes_written += word.size() + 1;
-            }
-            os << "\n\n";
+            w.begin_entry();
+            print_name(w);
+            w.end_entry(desc());
+        }
+        virtual std::size_t
+            object_size() const override
+        {
+            return sizeof(*this);
         }
     };
     class multi_flag
@@ -1109,23 +4955,33 @@ namespace po
             auto po = detail::helper::pick_option_with_default<ParentGroup>(std::nullopt, args...);
             po->get().register_option(this);
         }
-        virtual void
-            notify() const override
+        bool
+            get(const parse_result& pr) const
         {
-            if (parsed_count() < _min)
+            return parsed(pr);
+        }
+        virtual po::error
+            check(const parse_result& pr) const override
+        {
+            po::error result;
+            if (parsed_count(pr) < _min)
             {
-                throw std::runtime_error("po error: flag \"" + std::string(name()) +
-                    "\" appeared too less (min=" + std::to_string(_min) + ")");
+                result = po::error(ErrorCode::FlagTooFew, po::error::npos, name(), {}, _min);
             }
-            else if (parsed_count() > _max)
+            else if (parsed_count(pr) > _max)
             {
-                throw std::runtime_error("po error: flag \"" + std::string(name()) +
-                    "\" appeared too often (max=" + std::to_string(_max) + ")");
+                result = po::error(ErrorCode::FlagTooMany, po::error::npos, name(), {}, _max);
             }
+            return result;
         }
         virtual void
-            print_help(std::ostream& os, int argc, const char** argv) const override
+            print_help(detail::helper::help_writer&, std::string_view) const override
+        {
+        }
+        virtual std::size_t
+            object_size() const override
         {
+            return sizeof(*this);
         }
 
     private:
@@ -1137,6 +4993,7 @@ namespace po
     {
     public:
         using type_t = std::vector<T>;
+        using result_t = std::pmr::vector<detail::helper::result_type_t<T>>;
         using base1_t = flag;
         using valid_options_t = std::tuple<ParentGroup, LongName, ShortName, Min, Max, Pattern>;
 
@@ -1155,28 +5012,45 @@ namespace po
             static_assert(detail::helper::has_type<Pattern, std::tuple<Args...>>::value, "po error static_assert: missing option \"pattern\" for multi_pattern_flag");
         }
         virtual ParseStatus
-            try_parse_option(int* argc, const char*** argv) override
+            try_parse_option(detail::token_stream& ts, parse_result& pr) const override
         {
-            auto ret = base1_t::try_parse_option(argc, argv);
+            auto ret = base1_t::try_parse_option(ts, pr);
             if (ret == ParseStatus::Match)
             {
-                auto pa = base1_t::parsed_pattern_argument();
-                auto value = detail::helper::lexical_cast<T>(pa);
-                _arguments.push_back(value);
+                std::optional<detail::helper::result_type_t<T>> value;
+                ret = convert_argument<T>(base1_t::parsed_pattern_argument(pr), ts.position() - 1, pr, value);
+                if (value)
+                {
+                    base1_t::value<result_t>(pr).push_back(std::move(*value));
+                }
             }
             return ret;
         }
+        virtual std::unique_ptr<detail::base_value>
+            create_value(std::pmr::memory_resource* mr) const override
+        {
+            return std::make_unique<detail::container_value<result_t>>(mr);
+        }
+        const result_t&
+            get(const parse_result& pr) const
+        {
+            return base1_t::value<result_t>(pr);
+        }
         operator type_t() const
         {
-            return _arguments;
+            return detail::helper::to_type<type_t>(get(default_result()));
         }
         virtual void
-            print_help(std::ostream& os) const override
+            print_help(detail::helper::help_writer&, std::string_view) const override
+        {
+        }
+        virtual std::size_t
+            object_size() const override
         {
+            return sizeof(*this);
         }
 
     private:
-        type_t _arguments;
         std::size_t _min, _max;
     };
     class help
@@ -1199,31 +5073,34 @@ namespace po
                 , "po error static_assert: unkown option given for help");
         }
         virtual ParseStatus
-            try_parse_option(int narg, int* argc, const char*** argv) override
+            try_parse_option(detail::token_stream& ts, parse_result& pr) const override
         {
-            auto ret = base1_t::try_parse_option(narg, argc, argv);
+            auto ret = base1_t::try_parse_option(ts, pr);
             if (ret == ParseStatus::Match)
             {
-                std::stringstream ss;
-                parent()->get().print_help(ss, *argc + (narg - *argc + 1), *argv - (narg - *argc + 1));
-                throw help_ex(ss.str());
+                pr.set_help_group(&parent()->get());
             }
             return ret == ParseStatus::Match ? ParseStatus::HelpParsed : ParseStatus::NoMatch;
         }
-        const std::string&
+        std::string_view
             header() const
         {
             return _header;
         }
-        const std::string&
+        std::string_view
             message() const
         {
             return _message;
         }
+        virtual std::size_t
+            object_size() const override
+        {
+            return sizeof(*this);
+        }
 
     private:
-        std::string _header;
-        std::string _message;
+        std::string_view _header;
+        std::string_view _message;
     };
     template <class T>
     class argument
@@ -1231,8 +5108,9 @@ namespace po
     {
     public:
         using type_t = T;
+        using result_t = detail::helper::result_type_t<T>;
         using base1_t = detail::base_argument<T>;
-        using valid_options_t = std::tuple<ParentGroup, LongName, ShortName, Desc, Min, Max, Pattern, Def<T>, ArgName>;
+        using valid_options_t = std::tuple<ParentGroup, LongName, ShortName, Desc, Min, Max, Pattern, Def<T>, ArgName, Lazy>;
 
         template <class... Args>
         argument(Args&&... args)
@@ -1246,48 +5124,94 @@ namespace po
                 , detail::helper::pick_option_with_default<Desc>("", args...)
                 , detail::helper::pick_option_with_default<ArgName>("", args...))
             , _def(detail::helper::pick_option_with_default<Def<T>>(std::nullopt, args...))
+            , _lazy(detail::helper::pick_option_with_default<Lazy>(false, args...))
         {
             static_assert((detail::helper::has_type<Args, valid_options_t>::value && ...)
                 , "po error static_assert: unkown option given for argument");
-            auto def = detail::helper::pick_option_with_default<Def<T>>(std::nullopt, args...);
-            if (def)
-            {
-                _argument = *detail::helper::pick_option_with_default<Def<T>>(std::nullopt, args...);
-            }
         }
         virtual ParseStatus
-            try_parse_option(int narg, int* argc, const char*** argv) override
+            try_parse_option(detail::token_stream& ts, parse_result& pr) const override
         {
-            auto ret = base1_t::try_parse_option_argument(narg, argc, argv);
-            if (ret)
+            ParseStatus result = ParseStatus::NoMatch;
+            if (_lazy)
+            {
+                std::string_view text;
+                result = base1_t::try_parse_option_text(ts, pr, text);
+                if (result == ParseStatus::Match)
+                {
+                    base1_t::template value_object<lazy_t>(pr).add(text, ts.position() - 1);
+                }
+            }
+            else
             {
-                _argument = *ret;
+                std::optional<result_t> value;
+                result = base1_t::try_parse_option_argument(ts, pr, value);
+                if (value)
+                {
+                    base1_t::template value<result_t>(pr) = std::move(*value);
+                }
             }
-            return ret ? ParseStatus::Match : ParseStatus::NoMatch;
+            return result;
         }
-        operator T() const
+        virtual std::unique_ptr<detail::base_value>
+            create_value(std::pmr::memory_resource* mr) const override
         {
-            return _argument;
+            std::unique_ptr<detail::base_value> result;
+            if (_lazy)
+            {
+                result = std::make_unique<lazy_t>([](result_t& data, std::string_view text, std::pmr::memory_resource* mr_)
+                    {
+                        std::optional<result_t> value;
+                        auto ec = detail::helper::try_lexical_cast<T>(text, value, mr_);
+                        if (value)
+                        {
+                            data = std::move(*value);
+                        }
+                        return ec;
+                    }, base1_t::name(), mr, result_t(_def ? *_def : T{}), mr);
+            }
+            else
+            {
+                result = std::make_unique<detail::value<result_t>>(result_t(_def ? *_def : T{}), mr);
+            }
+            return result;
         }
-        virtual void
-            notify() const override
+        const result_t&
+            get(const parse_result& pr) const
         {
-            if (!_def && parsed())
+            if (_lazy)
             {
-                base1_t::notify();
+                base1_t::convert(pr);
             }
+            return base1_t::template value<result_t>(pr);
+        }
+        operator T() const
+        {
+            return detail::helper::to_type<T>(get(base1_t::default_result()));
+        }
+        virtual po::error
+            check(const parse_result& pr) const override
+        {
+            return !_def && base1_t::parsed(pr) ? base1_t::check(pr) : po::error();
         }
         virtual void
-            print_help(std::ostream& os, int argc, const char** argv) const override
+            print_help(detail::helper::help_writer& w, std::string_view) const override
+        {
+            w.begin_entry();
+            base1_t::print_name_argument(w, _def);
+            w.end_entry(base1_t::desc());
+        }
+        virtual std::size_t
+            object_size() const override
         {
-            std::string name_ = get_print_name_argument(_def);
-            detail::helper::print_2_columns(os, name_, desc());
-            os << "\n\n";
+            return sizeof(*this);
         }
 
     private:
+        using lazy_t = detail::lazy_value<result_t>;
+
         std::optional<T> _def;
-        T _argument;
+        bool _lazy;
     };
     template <class T>
     class optional_argument
@@ -1295,6 +5219,7 @@ namespace po
     {
     public:
         using type_t = std::optional<T>;
+        using result_t = std::optional<detail::helper::result_type_t<T>>;
         using base1_t = detail::base_argument<T>;
         using valid_options_t = std::tuple<ParentGroup, LongName, ShortName, Desc, ArgName>;
 
@@ -1314,73 +5239,44 @@ namespace po
                 , "po error static_assert: unkown option given for optional_argument");
         }
         virtual ParseStatus
-            try_parse_option(int narg, int* argc, const char*** argv) override
+            try_parse_option(detail::token_stream& ts, parse_result& pr) const override
         {
-            auto ret = base1_t::try_parse_option_argument(narg, argc, argv);
-            if (ret)
+            result_t value;
+            auto result = base1_t::try_parse_option_argument(ts, pr, value);
+            if (value)
             {
-                _argument = ret;
+                base1_t::template value<result_t>(pr) = std::move(value);
             }
-            return ret ? ParseStatus::Match : ParseStatus::NoMatch;
+            return result;
+        }
+        virtual std::unique_ptr<detail::base_value>
+            create_value(std::pmr::memory_resource* mr) const override
+        {
+            return std::make_unique<detail::value<result_t>>(result_t(), mr);
+        }
+        const result_t&
+            get(const parse_result& pr) const
+        {
+            return base1_t::template value<result_t>(pr);
         }
         operator std::optional<T>() const
         {
-            return _argument;
+            return detail::helper::to_type<type_t>(get(base1_t::default_result()));
         }
         virtual void
-            print_help(std::ostream& os, int argc, const char** argv) const override
+            print_help(detail::helper::help_writer& w, std::string_view) const override
         {
-            std::string name_ = "[";
-            if (short_name() != 0)
-            {
-                name_ += "-";
-                name_.push_back(short_name());
-                if (long_name() != "")
-                {
-                    name_ += " | --" + std::string(long_name());
-                }
-            }
-            else
-            {
-                name_ += "--" + std::string(long_name());
-            }
-            if (arg_name() != "")
-            {
-                name_ += " <" + std::string(arg_name()) + ">]";
-            }
-            else
-            {
-                name_ += " <arg>]";
-            }
-            os << "  ";
-            os << std::setw(26) << std::left << name_;
-            if (name_.size() > 22 && desc() != "")
-            {
-                os << "\n";
-            }
-            std::stringstream desc_{std::string(desc())};
-            std::size_t bytes_written = 0;
-            while (desc_)
-            {
-                std::string word;
-                desc_ >> word;
-                if (bytes_written > 0 && bytes_written + word.size() > 32)
-                {
-                    bytes_written = 0;
-                    os << "\n  " << std::setw(26) << "";
-                }
-                if (word == "")
-                {
-                    break;
-                }
-                os << word << " ";
-                bytes_written += word.size() + 1;
-            }
-            os << "\n\n";
+            w.begin_entry();
+            w << '[';
+            base1_t::print_name_argument(w, std::optional<T>{});
+            w << ']';
+            w.end_entry(base1_t::desc());
+        }
+        virtual std::size_t
+            object_size() const override
+        {
+            return sizeof(*this);
         }
-
-    private:
-        std::optional<T> _argument;
     };
     template <class T>
     class multi_argument
@@ -1388,54 +5284,134 @@ namespace po
     {
     public:
         using type_t = std::vector<T>;
+        using result_t = std::pmr::vector<detail::helper::result_type_t<T>>;
         using base1_t = detail::base_argument<T>;
-        using valid_options_t = std::tuple<ParentGroup, LongName, ShortName, Min, Max>;
+        using valid_options_t = std::tuple<ParentGroup, LongName, ShortName, Min, Max, Desc, ArgName, Reserve, Lazy, Parallel>;
 
         template <class... Args>
-        multi_argument(detail::base_group& parent_group, Args&&... args)
+        multi_argument(Args&&... args)
             : base1_t(
                   detail::helper::pick_option_with_default<ParentGroup>(std::nullopt, args...)
                 , detail::helper::pick_option_with_default<LongName>("", args...)
                 , detail::helper::pick_option_with_default<ShortName>(0, args...)
                 , detail::helper::pick_option_with_default<Min>(1, args...)
                 , detail::helper::pick_option_with_default<Max>(1, args...)
-                , "")
+                , ""
+                , detail::helper::pick_option_with_default<Desc>("", args...)
+                , detail::helper::pick_option_with_default<ArgName>("", args...))
+            , _reserve(detail::helper::pick_option_with_default<Reserve>(0, args...))
+            , _lazy(detail::helper::pick_option_with_default<Lazy>(false, args...))
+            , _parallel(detail::helper::pick_option_with_default<Parallel>(0, args...))
+            , _deferred(_lazy || (_parallel != 0 && bulk_t::parallel_safe && detail::worker_pool::concurrency() > 1))
         {
             static_assert((detail::helper::has_type<Args, valid_options_t>::value && ...)
                 , "po error static_assert: unkown option given for multi_argument");
         }
 
         virtual ParseStatus
-            try_parse_option(int* argc, const char*** argv) override
+            try_parse_option(detail::token_stream& ts, parse_result& pr) const override
+        {
+            ParseStatus result = ParseStatus::NoMatch;
+            if (_deferred)
+            {
+                std::string_view text;
+                result = base1_t::try_parse_option_text(ts, pr, text);
+                if (result == ParseStatus::Match)
+                {
+                    base1_t::template value_object<bulk_t>(pr).add(text, ts.position() - 1);
+                }
+            }
+            else
+            {
+                std::optional<detail::helper::result_type_t<T>> value;
+                result = base1_t::try_parse_option_argument(ts, pr, value);
+                if (value)
+                {
+                    base1_t::template value<result_t>(pr).push_back(std::move(*value));
+                }
+            }
+            return result;
+        }
+        virtual std::unique_ptr<detail::base_value>
+            create_value(std::pmr::memory_resource* mr) const override
+        {
+            std::unique_ptr<detail::base_value> result;
+            if (_deferred)
+            {
+                result = std::make_unique<bulk_t>(base1_t::name(), mr, _reserve, _parallel, _lazy);
+            }
+            else
+            {
+                result = std::make_unique<detail::container_value<result_t>>(mr, _reserve);
+            }
+            return result;
+        }
+        const result_t&
+            get(const parse_result& pr) const
         {
-            auto ret = base1_t::try_parse_option_argument(argc, argv);
-            if (ret)
+            if (_deferred)
             {
-                _arguments.push_back(*ret);
+                base1_t::convert(pr);
             }
-            return ret ? ParseStatus::Match : ParseStatus::NoMatch;
+            return base1_t::template value<result_t>(pr);
         }
         operator std::vector<T>() const
         {
-            return _arguments;
+            return detail::helper::to_type<type_t>(get(base1_t::default_result()));
         }
         virtual void
-            print_help(std::ostream& os) const override
+            print_help(detail::helper::help_writer& w, std::string_view) const override
+        {
+            w.begin_entry();
+            base1_t::print_name_argument(w, std::optional<T>{});
+            w.end_entry(base1_t::desc());
+        }
+        virtual std::size_t
+            object_size() const override
         {
+            return sizeof(*this);
         }
 
     private:
-        std::vector<T> _arguments;
+        using bulk_t = detail::bulk_value<T>;
+
+        std::size_t _reserve;
+        bool _lazy;
+        std::size_t _parallel;
+        // Keeps the texts to convert them later, Parallel on a single core or for a type that can't be converted
+        // in parallel converts while parsing
+        bool _deferred;
+    };
+
+    // Storage policies for the results of multi_pattern_argument. All of them find std::string keys by
+    // std::string_view
+    struct ordered_storage
+    {
+        template <class K, class V>
+        using container_t = std::pmr::map<K, V, std::less<>>;
+    };
+    // Sorted vector, built once after parsing
+    struct flat_storage
+    {
+        template <class K, class V>
+        using container_t = detail::flat_map<K, V>;
+    };
+    // Open addressing hash table, iterates in insertion order
+    struct hash_storage
+    {
+        template <class K, class V>
+        using container_t = detail::hash_map<K, V>;
     };
 
-    template <class KeyT, class ValueT>
+    template <class KeyT, class ValueT, class Storage = ordered_storage>
     class multi_pattern_argument
         : public detail::base_argument<ValueT>
     {
     public:
         using base1_t = detail::base_argument<ValueT>;
         using type_t = std::map<KeyT, ValueT>;
-        using valid_options_t = std::tuple<ParentGroup, LongName, ShortName, Min, Max, Pattern>;
+        using result_t = typename Storage::template container_t<detail::helper::result_type_t<KeyT>, detail::helper::result_type_t<ValueT>>;
+        using valid_options_t = std::tuple<ParentGroup, LongName, ShortName, Min, Max, Pattern, Desc, ArgName, Reserve>;
 
         template <class... Args>
         multi_pattern_argument(Args&&... args)
@@ -1445,37 +5421,66 @@ namespace po
                 , detail::helper::pick_option_with_default<ShortName>(0, args...)
                 , detail::helper::pick_option_with_default<Min>(1, args...)
                 , detail::helper::pick_option_with_default<Max>(std::size_t(-1), args...)
-                , detail::helper::pick_option_with_default<Pattern>("", args...))
+                , detail::helper::pick_option_with_default<Pattern>("", args...)
+                , detail::helper::pick_option_with_default<Desc>("", args...)
+                , detail::helper::pick_option_with_default<ArgName>("", args...))
+            , _reserve(detail::helper::pick_option_with_default<Reserve>(0, args...))
         {
             static_assert((detail::helper::has_type<Args, valid_options_t>::value && ...)
                 , "po error static_assert: unkown option given for multi_pattern_argument");
             static_assert(detail::helper::has_type<Pattern, std::tuple<Args...>>::value, "po error static_assert: missing option \"pattern\" for multi_pattern_argument");
         }
         virtual ParseStatus
-            try_parse_option(int* argc, const char*** argv) override
+            try_parse_option(detail::token_stream& ts, parse_result& pr) const override
         {
-            auto ret = base1_t::try_parse_option_argument(argc, argv);
-            if (ret)
+            std::size_t token = ts.position();
+            std::optional<detail::helper::result_type_t<ValueT>> value;
+            auto result = base1_t::try_parse_option_argument(ts, pr, value);
+            if (value)
             {
-                auto pa = base1_t::parsed_pattern_argument();
-                auto key = detail::helper::lexical_cast<KeyT>(pa);
-                _arguments[key] = *ret;
+                std::optional<detail::helper::result_type_t<KeyT>> key;
+                result = base1_t::template convert_argument<KeyT>(base1_t::parsed_pattern_argument(pr), token, pr, key);
+                if (key)
+                {
+                    base1_t::template value<result_t>(pr).insert_or_assign(std::move(*key), std::move(*value));
+                }
             }
-            return ret ? ParseStatus::Match : ParseStatus::NoMatch;
+            return result;
+        }
+        virtual std::unique_ptr<detail::base_value>
+            create_value(std::pmr::memory_resource* mr) const override
+        {
+            return std::make_unique<detail::container_value<result_t>>(mr, _reserve);
+        }
+        const result_t&
+            get(const parse_result& pr) const
+        {
+            return base1_t::template value<result_t>(pr);
         }
         operator type_t() const
         {
-            return _arguments;
+            return detail::helper::to_type<type_t>(get(base1_t::default_result()));
+        }
+        virtual void
+            print_help(detail::helper::help_writer&, std::string_view) const override
+        {
+        }
+        virtual std::size_t
+            object_size() const override
+        {
+            return sizeof(*this);
         }
 
     private:
-        type_t _arguments;
+        std::size_t _reserve;
     };
+    template <class T = std::string_view>
     class positional_argument
         : public detail::base_group
     {
     public:
-        using type_t = std::string_view;
+        using type_t = T;
+        using result_t = detail::helper::result_type_t<T>;
         using base1_t = detail::base_group;
         using valid_options_t = std::tuple<ParentGroup, LongName, ShortName, After, BindTo, Desc>;
         
@@ -1510,57 +5515,91 @@ namespace po
         }
 
         virtual ParseStatus
-            try_parse_option(int narg, int* argc, const char*** argv) override
+            try_parse_option(detail::token_stream& ts, parse_result& pr) const override
         {
             ParseStatus result = ParseStatus::NoMatch;
-            if (*argc != 0 && (**argv)[0] == '-')
+            if (!ts.empty() && ts.peek().kind == detail::TokenKind::Word)
             {
-                _argument = **argv;
-                set_parsed_argument(_argument);
-                (*argc)--;
-                (*argv)++;
-                if (bind_to() != nullptr)
+                result = ParseStatus::Match;
+                if constexpr (!std::is_same_v<T, std::string_view>)
+                {
+                    std::optional<result_t> v;
+                    result = convert_argument<T>(ts.peek().text(), ts.position(), pr, v);
+                    if (v)
+                    {
+                        value<result_t>(pr) = std::move(*v);
+                    }
+                }
+                if (result == ParseStatus::Match)
                 {
-                    bind_to()->try_parse_option(narg, argc, argv);
+                    set_parsed_argument(pr, ts.peek().text());
+                    ts.advance();
                 }
-                result = ParseStatus::Match;
             }
-            if (after() != nullptr)
+            return result;
+        }
+        virtual bool
+            positional() const override
+        {
+            return true;
+        }
+        // string_view positionals are read directly from the parsed argument, they need no storage
+        virtual std::unique_ptr<detail::base_value>
+            create_value(std::pmr::memory_resource* mr) const override
+        {
+            std::unique_ptr<detail::base_value> result;
+            if constexpr (!std::is_same_v<T, std::string_view>)
             {
-                after()->try_parse_option(narg, argc, argv);
+                result = std::make_unique<detail::value<result_t>>(result_t(), mr);
             }
             return result;
         }
+        decltype(auto)
+            get(const parse_result& pr) const
+        {
+            if constexpr (std::is_same_v<T, std::string_view>)
+            {
+                return parsed_argument(pr);
+            }
+            else
+            {
+                return static_cast<const result_t&>(value<result_t>(pr));
+            }
+        }
         operator type_t() const
         {
-            return _argument;
+            return detail::helper::to_type<type_t>(get(default_result()));
         }
-        void virtual
-            notify() const override
+        virtual po::error
+            check(const parse_result& pr) const override
         {
-            if (parsed())
-            {
-                if (bind_to() != nullptr)
-                {
-                    bind_to()->notify();
-                }
+            po::error result;
+            if (parsed(pr) && bind_to() != nullptr)
+            {
+                result = bind_to()->check(pr);
             }
-            if (after() != nullptr)
+            if (after() != nullptr && !result)
             {
-                after()->notify();
+                result = after()->check(pr);
             }
+            return result;
+        }
+        virtual std::size_t
+            object_size() const override
+        {
+            return sizeof(*this);
         }
-
-    private:
-        type_t _argument;
     };
+    // Collects the remaining arguments in command line order
+    template <class T = std::string_view>
     class multi_positional_argument
         : public detail::base_option
     {
     public:
-        using type_t = std::set<std::string_view>;
+        using type_t = std::vector<T>;
+        using result_t = std::pmr::vector<detail::helper::result_type_t<T>>;
         using base1_t = detail::base_option;
-        using valid_options_t = std::tuple<ParentGroup, Min, Max, After, BindTo, Desc, ArgName>;
+        using valid_options_t = std::tuple<ParentGroup, Min, Max, After, BindTo, Desc, ArgName, OnArgument<detail::helper::result_type_t<T>>, Reserve>;
         
         template <class... Args>
         multi_positional_argument(Args&&... args)
@@ -1575,6 +5614,8 @@ namespace po
                 , detail::helper::pick_option_with_default<ArgName>("", args...))
             , _min(detail::helper::pick_option_with_default<Min>(1, args...))
             , _max(detail::helper::pick_option_with_default<Max>(std::size_t(-1), args...))
+            , _on_argument(detail::helper::pick_option_with_default<OnArgument<detail::helper::result_type_t<T>>>(nullptr, args...))
+            , _reserve(detail::helper::pick_option_with_default<Reserve>(0, args...))
         {
             static_assert((detail::helper::has_type<Args, valid_options_t>::value && ...)
                 , "po error static_assert: unkown option given for positional_argument");
@@ -1598,53 +5639,102 @@ namespace po
         }
 
         virtual ParseStatus
-            try_parse_option(int narg, int* argc, const char*** argv) override
+            try_parse_option(detail::token_stream& ts, parse_result& pr) const override
         {
             ParseStatus result = ParseStatus::NoMatch;
-            if (*argc != 0)
+            if (!ts.empty() && ts.peek().kind == detail::TokenKind::Terminator)
+            {
+                ts.advance();
+            }
+            if (!ts.empty())
             {
-                while (*argc)
+                // With OnArgument every converted argument is handed over as soon as it is parsed instead of being
+                // collected, and its token is dropped
+                auto& arguments = value<result_t>(pr);
+                if (!_on_argument)
                 {
-                    std::string_view value = **argv;
-                    set_parsed_argument(value);
-                    _arguments.insert(value);
-                    inc_parsed_count();
-                    (*argc)--;
-                    (*argv)++;
+                    arguments.reserve(arguments.size() + ts.remaining());
                 }
                 result = ParseStatus::Match;
+                while (!ts.empty() && result == ParseStatus::Match)
+                {
+                    std::string_view arg = ts.peek().text();
+                    set_parsed_argument(pr, arg);
+                    std::optional<detail::helper::result_type_t<T>> v;
+                    result = convert_argument<T>(arg, ts.position(), pr, v);
+                    if (v && _on_argument)
+                    {
+                        _on_argument(*v);
+                    }
+                    else if (v)
+                    {
+                        arguments.push_back(std::move(*v));
+                    }
+                    inc_parsed_count(pr);
+                    ts.advance();
+                    if (_on_argument)
+                    {
+                        ts.release();
+                    }
+                }
             }
             return result;
         }
+        virtual bool
+            positional() const override
+        {
+            return true;
+        }
+        virtual bool
+            streams() const override
+        {
+            return bool(_on_argument);
+        }
+        virtual std::unique_ptr<detail::base_value>
+            create_value(std::pmr::memory_resource* mr) const override
+        {
+            return std::make_unique<detail::container_value<result_t>>(mr, _reserve);
+        }
+        const result_t&
+            get(const parse_result& pr) const
+        {
+            return value<result_t>(pr);
+        }
         operator type_t() const
         {
-            return _arguments;
+            return detail::helper::to_type<type_t>(get(default_result()));
         }
-        void virtual
-            notify() const override
+        virtual po::error
+            check(const parse_result& pr) const override
         {
-            if (_min > parsed_count())
+            po::error result;
+            if (_min > parsed_count(pr))
             {
-                throw std::runtime_error("po error: too less arguments for positional arguments (min=" +
-                    std::to_string(_min) + ")");
+                result = po::error(ErrorCode::TooFewPositionals, po::error::npos, name(), {}, _min);
             }
-            else if (_max < parsed_count())
+            else if (_max < parsed_count(pr))
             {
-                throw std::runtime_error("po error: too many arguments for \"" +
-                    std::string(name()) + "\" (max=" + std::to_string(_max) + ")");
+                result = po::error(ErrorCode::TooManyPositionals, po::error::npos, name(), {}, _max);
             }
+            return result;
         }
         virtual void
-            print_help(std::ostream& os, int argc, const char** argv) const override
+            print_help(detail::helper::help_writer& w, std::string_view) const override
         {
-            std::string name_ = get_print_name_positional();
-            detail::helper::print_2_columns(os, name_, desc());
-            os << "\n\n";
+            w.begin_entry();
+            print_name_positional(w);
+            w.end_entry(desc());
+        }
+        virtual std::size_t
+            object_size() const override
+        {
+            return sizeof(*this);
         }
 
     private:
-        type_t _arguments;
         std::size_t _min, _max;
+        typename OnArgument<detail::helper::result_type_t<T>>::type_t _on_argument;
+        std::size_t _reserve;
     };
     class group
         : public detail::base_group
@@ -1682,10 +5772,20 @@ namespace po
                 pg->get().register_group(this);
             }
         }
+        bool
+            get(const parse_result& pr) const
+        {
+            return parsed(pr);
+        }
         operator bool() const
         {
             return parsed();
         }
+        virtual std::size_t
+            object_size() const override
+        {
+            return sizeof(*this);
+        }
     };
     template <class... Args>
     class sub_program
@@ -1702,14 +5802,22 @@ namespace po
             _base_group = &bg;
         }
         virtual int
-            operator()() override
+            operator()(const parse_result& pr) override
         {
-            return std::apply(_program, _member);
+            return std::apply([&](const auto&... member)
+                {
+                    return _program(detail::helper::to_type<typename Args::type_t>(pr[member])...);
+                }, _member);
         }
         virtual bool
-            parsed() const override
+            parsed(const parse_result& pr) const override
+        {
+            return _base_group->parsed(pr);
+        }
+        virtual std::size_t
+            object_size() const override
         {
-            return _base_group->parsed();
+            return sizeof(*this);
         }
 
     private:
@@ -1717,20 +5825,645 @@ namespace po
         std::tuple<const Args&...> _member;
         detail::base_group* _base_group;
     };
+
+    // Opt-in memory accounting. schema_footprint reports the bytes a schema takes, count the heap allocations
+    // the calling thread does while running a function, around parse_command_line, notify or execute_main for
+    // example. Counting needs PO_INIT_ALLOCATION_STATS in one translation unit of the program
+    class stats
+    {
+    public:
+        struct allocations
+        {
+            std::size_t count{0};
+            std::size_t bytes{0};
+        };
+        struct option_footprint
+        {
+            const detail::base_option* option;
+            std::size_t object_bytes;
+            std::size_t heap_bytes;
+        };
+        // Options and groups in id order, the heap memory captured by std::function members isn't visible
+        struct footprint
+        {
+            std::vector<option_footprint> options;
+            std::size_t parser_bytes{0};
+
+            std::size_t
+                total() const
+            {
+                std::size_t result = parser_bytes;
+                for (const auto& o : options)
+                {
+                    result += o.object_bytes + o.heap_bytes;
+                }
+                return result;
+            }
+        };
+
+        static bool
+            counting()
+        {
+            return detail::allocation_counter::installed;
+        }
+        static allocations
+            thread_allocations()
+        {
+            return {detail::allocation_counter::count, detail::allocation_counter::bytes};
+        }
+        template <class F>
+        static allocations
+            count(F&& f)
+        {
+            auto before = thread_allocations();
+            f();
+            auto after = thread_allocations();
+            return {after.count - before.count, after.bytes - before.bytes};
+        }
+        // For tests, runs f and throws if it allocated
+        template <class F>
+        static void
+            expect_no_allocations(F&& f)
+        {
+            if (!counting())
+            {
+                throw std::runtime_error("po error: counting allocations needs PO_INIT_ALLOCATION_STATS");
+            }
+            auto a = count(std::forward<F>(f));
+            if (a.count != 0)
+            {
+                throw std::runtime_error("po error: " + std::to_string(a.count) + " heap allocations ("
+                    + std::to_string(a.bytes) + " bytes) where none were expected");
+            }
+        }
+        static footprint
+            schema_footprint(const detail::parser& p)
+        {
+            footprint result;
+            for (const auto* op : p.options())
+            {
+                result.options.push_back({op, op->object_size(), op->heap_size()});
+            }
+            result.parser_bytes = p.footprint();
+            return result;
+        }
+    };
+
+    // Options of a po::schema. They are the option kinds flag, argument<T>, group and sub_program as plain types,
+    // a schema built from them needs no objects and no registration at runtime
+    namespace spec
+    {
+        template <detail::helper::fixed_string LongName, char ShortName = 0>
+        struct flag
+        {
+            using value_t = bool;
+        };
+        template <class T, detail::helper::fixed_string LongName, char ShortName = 0, bool Required = true>
+        struct argument
+        {
+            using value_t = T;
+        };
+        template <detail::helper::fixed_string Name, class... Options>
+        struct group
+        {
+            using value_t = bool;
+        };
+        // Group whose Program is called by schema::execute_main with the values of Options
+        template <detail::helper::fixed_string Name, auto Program, class... Options>
+        struct sub_program
+        {
+            using value_t = bool;
+        };
+    }
+
+    namespace detail
+    {
+        enum class SpecKind : std::uint8_t
+        {
+            Flag, Argument, Group
+        };
+        template <class... T>
+        struct type_list
+        {};
+        template <class... Lists>
+        struct concat;
+        template <>
+        struct concat<>
+        {
+            using type = type_list<>;
+        };
+        template <class... A>
+        struct concat<type_list<A...>>
+        {
+            using type = type_list<A...>;
+        };
+        template <class... A, class... B, class... Rest>
+        struct concat<type_list<A...>, type_list<B...>, Rest...>
+        {
+            using type = typename concat<type_list<A..., B...>, Rest...>::type;
+        };
+
+        template <class Option>
+        struct spec_traits;
+        template <helper::fixed_string LongName, char ShortName>
+        struct spec_traits<spec::flag<LongName, ShortName>>
+        {
+            static constexpr SpecKind kind = SpecKind::Flag;
+            static constexpr std::string_view name = LongName.view();
+            static constexpr char short_name = ShortName;
+            static constexpr bool required = false;
+            static constexpr std::size_t size = 1;
+            using children_t = type_list<>;
+        };
+        template <class T, helper::fixed_string LongName, char ShortName, bool Required>
+        struct spec_traits<spec::argument<T, LongName, ShortName, Required>>
+        {
+            static constexpr SpecKind kind = SpecKind::Argument;
+            static constexpr std::string_view name = LongName.view();
+            static constexpr char short_name = ShortName;
+            static constexpr bool required = Required;
+            static constexpr std::size_t size = 1;
+            using children_t = type_list<>;
+        };
+        template <helper::fixed_string Name, class... Options>
+        struct spec_traits<spec::group<Name, Options...>>
+        {
+            static constexpr SpecKind kind = SpecKind::Group;
+            static constexpr std::string_view name = Name.view();
+            static constexpr char short_name = 0;
+            static constexpr bool required = false;
+            static constexpr std::size_t size = (spec_traits<Options>::size + ... + 1);
+            using children_t = type_list<Options...>;
+        };
+        template <helper::fixed_string Name, auto Program, class... Options>
+        struct spec_traits<spec::sub_program<Name, Program, Options...>>
+            : spec_traits<spec::group<Name, Options...>>
+        {
+            template <class Values, std::size_t First>
+            static int
+                execute(const Values& values)
+            {
+                constexpr std::array<std::size_t, sizeof...(Options)> sizes{spec_traits<Options>::size...};
+                return [&]<std::size_t... J>(std::index_sequence<J...>)
+                {
+                    return Program(std::get<First + offset(sizes, J)>(values)...);
+                }(std::index_sequence_for<Options...>());
+            }
+
+        private:
+            static constexpr std::size_t
+                offset(const std::array<std::size_t, sizeof...(Options)>& sizes, std::size_t j)
+            {
+                std::size_t result = 0;
+                for (std::size_t k = 0; k < j; k++)
+                {
+                    result += sizes[k];
+                }
+                return result;
+            }
+        };
+
+        // An option of a schema together with its scope, 0 for the root and i + 1 for the group at index i
+        template <std::size_t Scope, class Option>
+        struct spec_node
+        {
+            using option_t = Option;
+            static constexpr std::size_t scope = Scope;
+        };
+        // Lists the options of a schema in pre-order, so the options of a group follow the group
+        template <std::size_t Scope, std::size_t Offset, class List>
+        struct flatten;
+        template <std::size_t Scope, std::size_t Offset>
+        struct flatten<Scope, Offset, type_list<>>
+        {
+            using type = type_list<>;
+        };
+        template <std::size_t Scope, std::size_t Offset, class Option, class... Rest>
+        struct flatten<Scope, Offset, type_list<Option, Rest...>>
+        {
+            using type = typename concat<
+                  type_list<spec_node<Scope, Option>>
+                , typename flatten<Offset + 1, Offset + 1, typename spec_traits<Option>::children_t>::type
+                , typename flatten<Scope, Offset + spec_traits<Option>::size, type_list<Rest...>>::type>::type;
+        };
+
+        struct spec_entry
+        {
+            std::size_t scope{0};
+            std::string_view name;
+            char short_name{0};
+            SpecKind kind{SpecKind::Flag};
+            bool required{false};
+            std::size_t index{0};
+        };
+        // Tables of a schema, sorted by scope and name and by scope and short name
+        template <class List>
+        struct spec_tables;
+        template <class... Nodes>
+        struct spec_tables<type_list<Nodes...>>
+        {
+            static constexpr std::size_t size = sizeof...(Nodes);
+            static constexpr std::size_t npos = std::size_t(-1);
+            using nodes_t = std::tuple<Nodes...>;
+            using values_t = std::tuple<typename Nodes::option_t::value_t...>;
+
+            static constexpr std::array<spec_entry, size>
+                make_entries()
+            {
+                std::array<spec_entry, size> result{};
+                std::size_t i = 0;
+                ((result[i] = spec_entry{Nodes::scope, spec_traits<typename Nodes::option_t>::name,
+                    spec_traits<typename Nodes::option_t>::short_name, spec_traits<typename Nodes::option_t>::kind,
+                    spec_traits<typename Nodes::option_t>::required, i}, i++), ...);
+                return result;
+            }
+            template <class Less>
+            static constexpr std::array<spec_entry, size>
+                make_sorted(Less less)
+            {
+                auto result = make_entries();
+                for (std::size_t i = 1; i < size; i++)
+                {
+                    for (std::size_t j = i; j > 0 && less(result[j], result[j - 1]); j--)
+                    {
+                        std::swap(result[j], result[j - 1]);
+                    }
+                }
+                return result;
+            }
+            static constexpr bool
+                by_name(const spec_entry& a, const spec_entry& b)
+            {
+                return a.scope < b.scope || (a.scope == b.scope && a.name < b.name);
+            }
+            static constexpr bool
+                by_short_name(const spec_entry& a, const spec_entry& b)
+            {
+                return a.scope < b.scope || (a.scope == b.scope && a.short_name < b.short_name);
+            }
+
+            static constexpr std::array<spec_entry, size> entries = make_entries();
+            static constexpr std::array<spec_entry, size> names = make_sorted(by_name);
+            static constexpr std::array<spec_entry, size> short_names = make_sorted(by_short_name);
+
+            static constexpr std::size_t
+                find(std::size_t scope, std::string_view name)
+            {
+                auto it = std::lower_bound(names.begin(), names.end(), spec_entry{scope, name}, by_name);
+                return it != names.end() && it->scope == scope && it->name == name ? it->index : npos;
+            }
+            static constexpr std::size_t
+                find(std::size_t scope, char short_name)
+            {
+                spec_entry key{scope, {}, short_name};
+                auto it = std::lower_bound(short_names.begin(), short_names.end(), key, by_short_name);
+                return short_name != 0 && it != short_names.end() && it->scope == scope && it->short_name == short_name ?
+                    it->index : npos;
+            }
+            static constexpr std::size_t
+                count(std::string_view name)
+            {
+                std::size_t result = 0;
+                for (auto& e : entries)
+                {
+                    result += e.name == name ? 1 : 0;
+                }
+                return result;
+            }
+            static constexpr std::size_t
+                index_of(std::string_view name)
+            {
+                std::size_t result = npos;
+                for (auto& e : entries)
+                {
+                    result = result == npos && e.name == name ? e.index : result;
+                }
+                return result;
+            }
+        };
+    }
+
+    // Parser generated at compile time from spec options:
+    //     using cli = po::schema<po::spec::flag<"verbose", 'v'>, po::spec::group<"up", po::spec::argument<int, "id">>>;
+    //     auto r = cli::parse(argc, argv);
+    //     cli::notify(r);
+    //     r.get<"id">();
+    // The lookup tables are constexpr, options are matched without virtual calls and the result lives on the
+    // stack. Options are found by their long name, which has to be unique within the schema for get
+    template <class... Options>
+    class schema
+    {
+        using tables_t = detail::spec_tables<typename detail::flatten<0, 0, detail::type_list<Options...>>::type>;
+
+        template <std::size_t I>
+        using option_t = typename std::tuple_element_t<I, typename tables_t::nodes_t>::option_t;
+
+    public:
+        class result
+        {
+        public:
+            template <detail::helper::fixed_string Name>
+            const auto&
+                get() const
+            {
+                static_assert(tables_t::count(Name.view()) == 1, "po error static_assert: option name not found or not unique in schema");
+                return std::get<tables_t::index_of(Name.view())>(_values);
+            }
+            template <detail::helper::fixed_string Name>
+            std::size_t
+                count() const
+            {
+                static_assert(tables_t::count(Name.view()) == 1, "po error static_assert: option name not found or not unique in schema");
+                return _counts[tables_t::index_of(Name.view())];
+            }
+            template <detail::helper::fixed_string Name>
+            bool
+                parsed() const
+            {
+                return count<Name>() > 0;
+            }
+
+        private:
+            friend class schema;
+
+            typename tables_t::values_t _values{};
+            std::array<std::uint32_t, tables_t::size> _counts{};
+        };
+
+        static void
+            parse(std::span<const std::string_view> args, result& r)
+        {
+            raise(try_parse(args, r));
+        }
+        static result
+            parse(std::span<const std::string_view> args)
+        {
+            result r;
+            parse(args, r);
+            return r;
+        }
+        static result
+            parse(int argc, const char** argv)
+        {
+            result r;
+            raise(try_parse(argc, argv, r));
+            return r;
+        }
+        static po::error
+            try_parse(std::span<const std::string_view> args, result& r)
+        {
+            return parse(args.size(), [&](std::size_t i)
+                {
+                    return args[i];
+                }, r);
+        }
+        static po::error
+            try_parse(int argc, const char** argv, result& r)
+        {
+            return parse(static_cast<std::size_t>(argc), [&](std::size_t i)
+                {
+                    return std::string_view(argv[i]);
+                }, r);
+        }
+        // Checks that every required argument of the root and of the parsed groups was given exactly once
+        static void
+            notify(const result& r)
+        {
+            raise(try_notify(r));
+        }
+        static po::error
+            try_notify(const result& r)
+        {
+            po::error ret;
+            for (auto it = tables_t::entries.begin(); !ret && it != tables_t::entries.end(); ++it)
+            {
+                auto& e = *it;
+                bool in_scope = e.scope == 0 || r._counts[e.scope - 1] > 0;
+                if (in_scope && e.kind == detail::SpecKind::Argument && e.required && r._counts[e.index] == 0)
+                {
+                    ret = po::error(ErrorCode::TooFewArguments, po::error::npos, e.name, {}, 1);
+                }
+                else if (e.kind == detail::SpecKind::Argument && r._counts[e.index] > 1)
+                {
+                    ret = po::error(ErrorCode::TooManyArguments, po::error::npos, e.name, {}, 1);
+                }
+            }
+            return ret;
+        }
+        // Calls the program of the innermost parsed sub_program
+        static std::optional<int>
+            execute_main(const result& r)
+        {
+            std::optional<int> ret;
+            execute(r, ret, std::make_index_sequence<tables_t::size>());
+            return ret;
+        }
+
+    private:
+        static void
+            raise(const po::error& e)
+        {
+            if (e)
+            {
+                throw std::runtime_error(e.message());
+            }
+        }
+        template <class Arg>
+        static po::error
+            parse(std::size_t size, Arg arg, result& r)
+        {
+            r = result();
+            po::error ret;
+            std::size_t scope = 0;
+            for (std::size_t i = 1; i < size && !ret; i++)
+            {
+                auto t = detail::token::classify(arg(i));
+                std::size_t id = tables_t::npos;
+                std::optional<std::string_view> value;
+                // Like the runtime parser leaving a group, an option not found in the current group is looked up in
+                // the groups around it and parsing goes on there
+                for (std::size_t level = scope; id == tables_t::npos; level = tables_t::entries[level - 1].scope)
+                {
+                    id = find(level, t);
+                    scope = id != tables_t::npos ? level : scope;
+                    if (level == 0)
+                    {
+                        break;
+                    }
+                }
+                switch (t.kind)
+                {
+                case detail::TokenKind::LongWithValue:
+                    value = t.value();
+                    break;
+                case detail::TokenKind::ShortCluster:
+                    value = t.size > 2 ? std::optional(t.value()) : std::nullopt;
+                    break;
+                default:
+                    break;
+                }
+                auto kind = id != tables_t::npos ? tables_t::entries[id].kind : detail::SpecKind::Flag;
+                if (id == tables_t::npos || (kind == detail::SpecKind::Group) != (t.kind == detail::TokenKind::Word) ||
+                    (kind != detail::SpecKind::Argument && value))
+                {
+                    ret = po::error(ErrorCode::UnknownArgument, i - 1, {}, t.text());
+                    break;
+                }
+                if (kind == detail::SpecKind::Argument && !value)
+                {
+                    if (i + 1 == size)
+                    {
+                        ret = po::error(ErrorCode::MissingValue, i - 1, tables_t::entries[id].name);
+                        break;
+                    }
+                    value = arg(++i);
+                }
+                std::errc ec{};
+                assign(id, value ? *value : std::string_view(), r, ec, std::make_index_sequence<tables_t::size>());
+                if (ec != std::errc{})
+                {
+                    ret = po::error::conversion(ec, i - 1, *value);
+                }
+                r._counts[id]++;
+                scope = kind == detail::SpecKind::Group ? id + 1 : scope;
+            }
+            return ret;
+        }
+        static std::size_t
+            find(std::size_t scope, const detail::token& t)
+        {
+            switch (t.kind)
+            {
+            case detail::TokenKind::Long:
+            case detail::TokenKind::LongWithValue:
+                return tables_t::find(scope, t.name());
+            case detail::TokenKind::ShortCluster:
+                return tables_t::find(scope, t.data[1]);
+            case detail::TokenKind::Word:
+                return tables_t::find(scope, t.text());
+            default:
+                return tables_t::npos;
+            }
+        }
+    private:
+        template <std::size_t... I>
+        static void
+            assign(std::size_t id, std::string_view value, result& r, std::errc& ec, std::index_sequence<I...>)
+        {
+            ((id == I ? (assign<I>(value, r, ec), true) : false) || ...);
+        }
+        template <std::size_t I>
+        static void
+            assign(std::string_view value, result& r, std::errc& ec)
+        {
+            if constexpr (detail::spec_traits<option_t<I>>::kind == detail::SpecKind::Argument)
+            {
+                ec = converter<typename option_t<I>::value_t>::from_string(value, std::get<I>(r._values));
+            }
+            else
+            {
+                std::get<I>(r._values) = true;
+            }
+        }
+        template <std::size_t... I>
+        static void
+            execute(const result& r, std::optional<int>& ret, std::index_sequence<I...>)
+        {
+            std::size_t last = tables_t::npos;
+            ((last = is_sub_program<option_t<I>>::value && r._counts[I] > 0 ? I : last), ...);
+            ((last == I ? (execute<I>(r, ret), true) : false) || ...);
+        }
+        template <std::size_t I>
+        static void
+            execute(const result& r, std::optional<int>& ret)
+        {
+            if constexpr (is_sub_program<option_t<I>>::value)
+            {
+                ret = detail::spec_traits<option_t<I>>::template execute<typename tables_t::values_t, I + 1>(r._values);
+            }
+        }
+        template <class Option>
+        struct is_sub_program
+            : std::false_type
+        {};
+        template <detail::helper::fixed_string Name, auto Program, class... Opts>
+        struct is_sub_program<spec::sub_program<Name, Program, Opts...>>
+            : std::true_type
+        {};
+    };
 }
 
-#define PO_INIT_MAIN_FILE_WITH_SUB_PROGRAM_SUPPORT(PARSER)      \
-    int                                                         \
-        main(int argc, const char** argv)                       \
-    {                                                           \
-        try                                                     \
-        {                                                       \
-            PARSER.parse_command_line(argc, argv);              \
-        }                                                       \
-        catch (const std::runtime_error& err)                   \
-        {                                                       \
-            std::cout << err.what();                            \
-        }                                                       \
-        PARSER.notify();                                        \
-        return *PARSER.execute_main();                          \
+#define PO_INIT_MAIN_FILE_WITH_SUB_PROGRAM_SUPPORT(PARSER)           \
+    int                                                              \
+        main(int argc, const char** argv)                            \
+    {                                                                \
+        if (PARSER.try_complete_command_line(argc, argv, std::cout)) \
+        {                                                            \
+            return 0;                                                \
+        }                                                            \
+        try                                                          \
+        {                                                            \
+            PARSER.parse_command_line(argc, argv);                   \
+        }                                                            \
+        catch (const po::help_ex& help)                              \
+        {                                                            \
+            help.print();                                            \
+            return 0;                                                \
+        }                                                            \
+        catch (const std::runtime_error& err)                        \
+        {                                                            \
+            std::cout << err.what();                                 \
+        }                                                            \
+        PARSER.notify();                                             \
+        return *PARSER.execute_main();                               \
+    }
+
+// Replaces the global operator new and delete to count the heap allocations of every thread for po::stats, use it
+// once at namespace scope in one translation unit of the program. The deletes aren't inlined, inlined into a caller
+// GCC pairs their free with its operator new and warns about a mismatch
+#define PO_INIT_ALLOCATION_STATS                                                        \
+    [[maybe_unused]] static const bool po_allocation_stats_installed =                  \
+        (po::detail::allocation_counter::installed = true);                             \
+    void*                                                                               \
+        operator new(std::size_t size)                                                  \
+    {                                                                                   \
+        po::detail::allocation_counter::add(size);                                      \
+        void* p = std::malloc(size != 0 ? size : 1);                                    \
+        if (p == nullptr)                                                               \
+        {                                                                               \
+            throw std::bad_alloc();                                                     \
+        }                                                                               \
+        return p;                                                                       \
+    }                                                                                   \
+    void*                                                                               \
+        operator new(std::size_t size, std::align_val_t al)                             \
+    {                                                                                   \
+        po::detail::allocation_counter::add(size);                                      \
+        auto a = static_cast<std::size_t>(al);                                          \
+        void* p = std::aligned_alloc(a, (size + a - 1) / a * a + (size == 0 ? a : 0));  \
+        if (p == nullptr)                                                               \
+        {                                                                               \
+            throw std::bad_alloc();                                                     \
+        }                                                                               \
+        return p;                                                                       \
+    }                                                                                   \
+    [[gnu::noinline]] void                                                              \
+        operator delete(void* p) noexcept                                               \
+    {                                                                                   \
+        std::free(p);                                                                   \
+    }                                                                                   \
+    [[gnu::noinline]] void                                                              \
+        operator delete(void* p, std::size_t) noexcept                                  \
+    {                                                                                   \
+        std::free(p);                                                                   \
+    }                                                                                   \
+    [[gnu::noinline]] void                                                              \
+        operator delete(void* p, std::align_val_t) noexcept                             \
+    {                                                                                   \
+        std::free(p);                                                                   \
+    }                                                                                   \
+    [[gnu::noinline]] void                                                              \
+        operator delete(void* p, std::size_t, std::align_val_t) noexcept                \
+    {                                                                                   \
+        std::free(p);                                                                   \
     }
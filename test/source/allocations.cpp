@@ -0,0 +1,75 @@
+#include <po.h>
+#include <iostream>
+
+// Counts the allocations of parse_command_line, notify and execute_main, and checks that parsing into a result
+// with an arena doesn't touch the heap once the result has been used
+PO_INIT_ALLOCATION_STATS
+
+static po::detail::parser parser;
+static po::flag verbose{po::ParentGroup(parser), po::LongName("verbose"), po::ShortName('v')};
+static po::argument<int> level{po::ParentGroup(parser), po::LongName("level"), po::ShortName('l'), po::Def<int>(1)};
+static po::argument<std::string> name{po::ParentGroup(parser), po::LongName("name"), po::Def<std::string>("")};
+static po::multi_argument<std::string_view> labels{po::ParentGroup(parser), po::LongName("label"), po::Min(0), po::Max(8)};
+static po::multi_pattern_argument<std::string_view, std::string_view> defines{po::ParentGroup(parser), po::Pattern("define-*"), po::Min(0)};
+static po::group run{po::ParentGroup(parser), po::LongName("run")};
+static po::argument<std::size_t> jobs{po::ParentGroup(run), po::LongName("jobs"), po::ShortName('j'), po::Def<std::size_t>(1)};
+static po::multi_positional_argument<> files{po::ParentGroup(run), po::Min(0)};
+static po::help help{po::ParentGroup(parser)};
+
+static std::size_t checksum = 0;
+
+int main_run(const std::size_t& j)
+{
+    checksum += j;
+    return 0;
+}
+
+static po::sub_program sub_run(parser, run, main_run, jobs);
+
+static void
+    print(std::string_view call, po::stats::allocations a)
+{
+    std::cout << std::left << std::setw(20) << call << std::right << std::setw(6) << a.count << " allocations"
+        << std::setw(8) << a.bytes << " bytes\n";
+}
+
+int main(int argc, const char** argv)
+{
+    try
+    {
+        for (int i = 0; i < 2; i++)
+        {
+            auto parse = po::stats::count([&] { parser.parse_command_line(argc, argv); });
+            auto notify = po::stats::count([&] { parser.notify(); });
+            auto execute = po::stats::count([&] { parser.execute_main(); });
+            std::cout << (i == 0 ? "first parse:\n" : "second parse:\n");
+            print("parse_command_line", parse);
+            print("notify", notify);
+            print("execute_main", execute);
+        }
+        // Strings and pattern keys of the default result come from the heap on every parse, with an arena the
+        // result doesn't allocate once it has been used
+        std::vector<std::string_view> args(argv, argv + argc);
+        auto result = parser.make_arena_result();
+        parser.parse(args, result);
+        po::stats::expect_no_allocations([&]
+            {
+                parser.parse(args, result);
+                parser.notify(result);
+                parser.execute_main(result);
+            });
+        auto footprint = po::stats::schema_footprint(parser);
+        for (const auto& o : footprint.options)
+        {
+            std::cout << std::left << std::setw(20) << (o.option->name() != "" ? std::string(o.option->name()) : "#" + std::to_string(o.option->id()))
+                << std::right << std::setw(6) << o.object_bytes << " + " << o.heap_bytes << " bytes\n";
+        }
+        std::cout << "parser: " << footprint.parser_bytes << " bytes, schema: " << footprint.total() << " bytes\n";
+    }
+    catch (const std::runtime_error& e)
+    {
+        std::cout << e.what() << "\n";
+        return 1;
+    }
+    return checksum == 0;
+}
@@ -0,0 +1,56 @@
+#include <po.h>
+#include "check.h"
+
+// Parses more lines than fit into a block with parse_batch and checks the outcome of every line, the presence
+// bitmaps and the columns, strings and vectors included, which outlive the results of the workers
+static po::detail::parser parser;
+static po::flag verbose{po::ParentGroup(parser), po::ShortName('v'), po::LongName("verbose")};
+static po::argument<std::string> name{po::ParentGroup(parser), po::ShortName('n'), po::LongName("name"), po::Def<std::string>("none")};
+static po::argument<std::uint32_t> priority{po::ParentGroup(parser), po::ShortName('p'), po::LongName("priority"), po::Def<std::uint32_t>(0)};
+static po::multi_argument<std::string> env{po::ParentGroup(parser), po::ShortName('e'), po::LongName("env"), po::Min(0), po::Max(4)};
+
+int main(int, const char**)
+{
+    std::size_t count = 1000;
+    std::vector<std::string> storage;
+    storage.reserve(count * 3);
+    std::vector<std::vector<std::string_view>> lines(count);
+    for (std::size_t i = 0; i < count; i++)
+    {
+        storage.push_back("a_job_name_longer_than_the_small_buffer_" + std::to_string(i));
+        storage.push_back(std::to_string(i));
+        storage.push_back("PATH=/opt/jobs/" + std::to_string(i) + "/bin");
+        lines[i] = {"batch", "--name", storage[i * 3], "-p", storage[i * 3 + 1], "-e", storage[i * 3 + 2], "--env=HOME=/"};
+        if (i % 3 == 0)
+        {
+            lines[i].erase(lines[i].begin() + 1, lines[i].begin() + 3);
+        }
+        if (i % 7 == 0)
+        {
+            lines[i].push_back("--unknown");
+        }
+    }
+
+    for (std::size_t threads : {1, 4})
+    {
+        auto batch = parser.parse_batch(lines, threads);
+        bool ok = batch.size() == count;
+        for (std::size_t i = 0; i < count && ok; i++)
+        {
+            bool valid = i % 7 != 0;
+            ok = bool(batch.line(i)) == valid && (valid || batch.line(i).error().code() == po::ErrorCode::UnknownArgument);
+            ok = ok && batch.parsed(priority, i) == valid && batch[priority][i] == (valid ? i : 0);
+            ok = ok && batch.parsed(name, i) == (valid && i % 3 != 0);
+            ok = ok && std::string_view(batch[name][i]) == (valid && i % 3 != 0 ? std::string_view(storage[i * 3]) : "none");
+            ok = ok && batch[env][i].size() == (valid ? 2 : 0) && (!valid || (batch[env][i][0] == std::string_view(storage[i * 3 + 2])
+                && batch[env][i][1] == "HOME=/"));
+        }
+        check(ok, "every line on " + std::to_string(threads) + " threads");
+        check(!batch.parsed(verbose, 1) && batch.presence(verbose).size() == (count + 63) / 64, "the bitmap of a flag");
+    }
+
+    auto batch = parser.parse_batch(std::vector<std::vector<std::string_view>>{{"batch", "-p", "x"}, {"batch", "-v"}});
+    check(batch.line(0).error().code() == po::ErrorCode::InvalidValue && batch.line(0).error().token() == 1, "a value that doesn't convert");
+    check(batch.line(1) && batch.parsed(verbose, 1) && !batch.parsed(priority, 1), "a small batch");
+    return failed;
+}
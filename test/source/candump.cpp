@@ -45,6 +45,47 @@ static po::multi_positional_argument can_interfaces{
     , po::ArgName("ifname[,<filter>*]")};
 static po::help help{po::ParentGroup(parser)};
 
+struct can_filter
+{
+    std::uint32_t can_id;
+    std::uint32_t can_mask;
+    bool inverted;
+};
+
+// <ifname>[,<filter>]* with <can_id>:<can_mask>, <can_id>~<can_mask>, #<error_mask> or [j|J]
+std::vector<can_filter> parse_filters(std::string_view interface, std::uint32_t& error_mask, bool& join)
+{
+    std::vector<can_filter> result;
+    auto pos = interface.find(',');
+    while (pos != std::string_view::npos)
+    {
+        auto next = interface.find(',', pos + 1);
+        auto filter = interface.substr(pos + 1, next == std::string_view::npos ? next : next - pos - 1);
+        auto sep = filter.find_first_of(":~");
+        if (filter.size() > 0 && filter[0] == '#')
+        {
+            error_mask = po::lexical_cast<po::hex<std::uint32_t>>(filter.substr(1));
+        }
+        else if (filter == "j" || filter == "J")
+        {
+            join = true;
+        }
+        else if (sep != std::string_view::npos)
+        {
+            result.push_back(can_filter{
+                  po::lexical_cast<po::hex<std::uint32_t>>(filter.substr(0, sep))
+                , po::lexical_cast<po::hex<std::uint32_t>>(filter.substr(sep + 1))
+                , filter[sep] == '~'});
+        }
+        else
+        {
+            throw std::runtime_error("candump error: invalid filter \"" + std::string(filter) + "\"");
+        }
+        pos = next;
+    }
+    return result;
+}
+
 int main(int argc, const char** argv)
 {
     try
@@ -53,9 +94,16 @@ int main(int argc, const char** argv)
     }
     catch (const po::help_ex& h)
     {
-        std::cout << h.what();
+        h.print();
         return 0;
     }
     parser.notify();
+    std::cout << "timestamp " << timestamp << ", silent mode " << silent_mode << "\n";
+    for (std::string_view interface : std::vector<std::string_view>(can_interfaces))
+    {
+        std::uint32_t error_mask = 0;
+        bool join = false;
+        parse_filters(interface, error_mask, join);
+    }
     return 0;
 }
@@ -0,0 +1,17 @@
+#pragma once
+
+#include <iostream>
+#include <string_view>
+
+// Checks of the tests that run as a plain program: a failed check is printed and main returns failed
+inline int failed = 0;
+
+inline void
+    check(bool ok, std::string_view what)
+{
+    if (!ok)
+    {
+        std::cout << "failed: " << what << "\n";
+        failed = 1;
+    }
+}
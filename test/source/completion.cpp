@@ -0,0 +1,75 @@
+#include <po.h>
+#include <chrono>
+#include <iostream>
+
+// Completes partial command lines of an nmcli like schema and compares the candidates with the expected ones
+static po::detail::parser parser;
+static po::flag terse{po::ParentGroup(parser), po::LongName("terse"), po::ShortName('t')};
+static po::argument<std::size_t> wait{po::ParentGroup(parser), po::LongName("wait"), po::ShortName('w'), po::Def<std::size_t>(0)};
+static po::multi_pattern_argument<std::string_view, std::string_view> defines{po::ParentGroup(parser), po::Pattern("define-*"), po::Min(0)};
+static po::group connection{po::ParentGroup(parser), po::LongName("connection")};
+static po::group show{po::ParentGroup(connection), po::LongName("show")};
+static po::flag active{po::ParentGroup(show), po::LongName("active")};
+static po::group up{po::ParentGroup(connection), po::LongName("up")};
+static po::flag ask{po::ParentGroup(up), po::LongName("ask"), po::ShortName('a')};
+static po::positional_argument<> id{po::LongName("<id>"), po::After(up)};
+static po::group ifname{po::After(id), po::LongName("ifname")};
+static po::positional_argument<> ifname_value{po::LongName("<ifname>"), po::BindTo(ifname)};
+static po::group device{po::ParentGroup(parser), po::LongName("device")};
+
+static std::string
+    join(const std::vector<po::completion>& candidates)
+{
+    std::string result;
+    for (const auto& c : candidates)
+    {
+        result += (result.empty() ? "" : " ") + c.text;
+    }
+    return result;
+}
+
+int main(int, const char**)
+{
+    struct query
+    {
+        std::vector<std::string_view> args;
+        std::string expected;
+    };
+    std::vector<query> queries{
+        {{"nmcli", ""}, "--terse --wait -t -w --define- connection device"},
+        {{"nmcli", "--w"}, "--wait"},
+        {{"nmcli", "-t", "-"}, "--terse --wait -t -w --define-"},
+        {{"nmcli", "--de"}, "--define-"},
+        {{"nmcli", "c"}, "connection"},
+        {{"nmcli", "connection", ""}, "show up"},
+        {{"nmcli", "connection", "up", ""}, "--ask -a <id>"},
+        {{"nmcli", "connection", "up", "home", "if"}, "ifname"},
+        {{"nmcli", "connection", "up", "home", "ifname", ""}, "<ifname>"},
+        {{"nmcli", "connection", "show", "--active", "--"}, "--active"},
+        {{"nmcli", "--bogus", ""}, ""}};
+
+    auto result = parser.make_result();
+    std::vector<po::completion> candidates;
+    int failed = 0;
+    for (const auto& q : queries)
+    {
+        parser.complete(q.args, q.args.size() - 1, result, candidates);
+        if (join(candidates) != q.expected)
+        {
+            std::cout << "completing \"" << q.args.back() << "\" after " << q.args.size() - 2 << " words: got \""
+                << join(candidates) << "\", expected \"" << q.expected << "\"\n";
+            failed = 1;
+        }
+    }
+
+    const auto& line = queries[7].args;
+    std::size_t n = 10000;
+    auto start = std::chrono::steady_clock::now();
+    for (std::size_t i = 0; i < n; i++)
+    {
+        parser.complete(line, line.size() - 1, result, candidates);
+    }
+    std::chrono::duration<double> d = std::chrono::steady_clock::now() - start;
+    std::cout << queries.size() << " completions checked, " << d.count() * 1e9 / n << " ns per completion\n";
+    return failed;
+}
@@ -0,0 +1,63 @@
+#include <po.h>
+#include "check.h"
+
+// Runs malformed command lines through the try_ functions, which report the error code, the token and the option
+// instead of throwing: a missing value, an unknown argument, a value that doesn't convert, a help option, an argument
+// given twice and try_validate of lazy options. The throwing functions report the same message
+static po::detail::parser parser;
+static po::help main_help{po::ParentGroup(parser)};
+static po::flag verbose{po::ParentGroup(parser), po::LongName("verbose"), po::ShortName('v')};
+static po::argument<int> level{po::ParentGroup(parser), po::LongName("level"), po::ShortName('l')};
+static po::argument<int> count{po::ParentGroup(parser), po::LongName("count"), po::Def<int>(1), po::Lazy(true)};
+static po::multi_argument<std::string_view> names{po::ParentGroup(parser), po::LongName("name"), po::Min(0), po::Max(4), po::Lazy(true)};
+
+int main(int, const char**)
+{
+    auto pr = parser.make_result();
+    auto status = parser.try_parse(std::vector<std::string_view>{"errors", "-v", "--level"}, pr);
+    check(!status && status.error().code() == po::ErrorCode::MissingValue && status.error().name() == "level"
+        && status.error().token() == 1, "an option without a value");
+    check(status.error().message() == "po error: missing value for \"level\"", "the message of a missing value");
+    status = parser.try_parse(std::vector<std::string_view>{"errors", "-l"}, pr);
+    check(!status && status.error().code() == po::ErrorCode::MissingValue && status.error().token() == 0, "a short option without a value");
+    status = parser.try_parse(std::vector<std::string_view>{"errors", "--name"}, pr);
+    check(!status && status.error().code() == po::ErrorCode::MissingValue && status.error().name() == "name", "a lazy option without a value");
+    status = parser.try_parse(std::vector<std::string_view>{"errors", "--level="}, pr);
+    check(!status && status.error().code() == po::ErrorCode::InvalidValue && status.error().text() == "",
+        "an empty value is given, but doesn't convert");
+
+    status = parser.try_parse(std::vector<std::string_view>{"errors", "-l", "2", "--unknown"}, pr);
+    check(!status && status.error().code() == po::ErrorCode::UnknownArgument && status.error().token() == 2
+        && status.error().text() == "--unknown", "an unknown argument");
+    status = parser.try_parse(std::vector<std::string_view>{"errors", "-l", "two"}, pr);
+    check(!status && status.error().code() == po::ErrorCode::InvalidValue && status.error().token() == 1
+        && status.error().name() == "level", "a value that doesn't convert");
+
+    status = parser.try_parse(std::vector<std::string_view>{"errors", "--help"}, pr);
+    check(status && status.status() == po::ParseStatus::HelpParsed && !status.error(), "a help option isn't an error");
+    check(parser.help_text(pr).find("--level") != std::string::npos, "the help text is read after the parse");
+
+    status = parser.try_parse(std::vector<std::string_view>{"errors", "-l", "1", "--level=2"}, pr);
+    auto e = parser.try_notify(pr);
+    check(status && e.code() == po::ErrorCode::TooManyArguments && e.name() == "level", "an argument given twice");
+
+    status = parser.try_parse(std::vector<std::string_view>{"errors", "-l", "1", "--count=3", "--name=a"}, pr);
+    check(status && !parser.try_notify(pr) && !pr.try_validate(), "valid options validate");
+    check(pr[count] == 3 && pr[names].size() == 1, "the lazy values after validate");
+    status = parser.try_parse(std::vector<std::string_view>{"errors", "--name=a", "--count", "x", "-l", "1"}, pr);
+    e = pr.try_validate();
+    check(status && e.code() == po::ErrorCode::InvalidValue && e.name() == "count" && e.token() == 2 && e.text() == "x",
+        "try_validate reports the lazy option that doesn't convert");
+    check(pr.try_validate().code() == po::ErrorCode::InvalidValue, "try_validate keeps reporting the error");
+
+    try
+    {
+        parser.parse(std::vector<std::string_view>{"errors", "--level"}, pr);
+        check(false, "parse throws");
+    }
+    catch (const std::runtime_error& ex)
+    {
+        check(std::string_view(ex.what()) == "po error: missing value for \"level\"", "parse throws the same message");
+    }
+    return failed;
+}
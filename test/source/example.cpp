@@ -5,17 +5,17 @@
 #include <po.h>
 
 // Initialize the library
-// This macro creates the single tone instance of the parser which holds references to the created options and provides a main, if you want write your own main the macro PO_INIT_MAIN_FILE instead can be used, 
-PO_INIT_MAIN_FILE_WITH_SUB_PROGRAM_SUPPORT()
+// The parser holds references to the created options, PO_INIT_MAIN_FILE_WITH_SUB_PROGRAM_SUPPORT (see end of file) provides a main for it
+static po::detail::parser parser;
 
 // The library introduces the concept of sub programs
 // It possible (but not mandatory) to create groups and assign them to a sub program which is invoked if the group gets parsed
 // Those relationships result in a tree as shown here in this example:
 
 // Here we build the tree
-static po::multi_pattern_flag<std::string> pflag1(po::LongName("pflag1"), po::Pattern("pflag1-*"));
-static po::multi_pattern_argument<std::string, double> parg1(po::LongName("parg1"), po::Pattern("parg1-*"));
-static po::group group1(po::LongName("group1"));
+static po::multi_pattern_flag<std::string> pflag1(po::ParentGroup(parser), po::LongName("pflag1"), po::Pattern("pflag1-*"));
+static po::multi_pattern_argument<std::string, double> parg1(po::ParentGroup(parser), po::LongName("parg1"), po::Pattern("parg1-*"));
+static po::group group1(po::ParentGroup(parser), po::LongName("group1"));
 static po::group group2(po::ParentGroup(group1), po::LongName("group2"));
 static po::group group3(po::ParentGroup(group2), po::LongName("group3"));
 static po::optional_argument<int> arg1(po::ParentGroup(group1), po::LongName("arg1"));
@@ -24,7 +24,7 @@ static po::argument<int> arg3(po::ParentGroup(group2), po::LongName("arg3"));
 static po::argument<int> arg4(po::ParentGroup(group3), po::LongName("arg4"), po::Def<int>(5));
 static po::flag flag1(po::ParentGroup(group3), po::LongName("flag1"), po::ShortName('f'));
 static po::multi_argument<std::filesystem::path> marg1(po::ParentGroup(group3), po::LongName("marg1"), po::Min(1), po::Max(10));
-static po::help main_help({});
+static po::help main_help{po::ParentGroup(parser)};
 static po::help goup1_help(po::ParentGroup(group1), po::Header("group1 help"));
 
 // Two main functions
@@ -62,6 +62,8 @@ int main_sub_group3(
 }
 // Register the main functions
 // main_sub gets invoked if the rout_group gets parsed (so main_sub behaves like the classic main function)
-static po::sub_program sp_default(main_sub);
+static po::sub_program sp_default(parser, parser, main_sub);
 // main_sub_group1 only gets invoekd if group1 gets parsed, the arguments passed to the function will be passed to main_sub_group1
-static po::sub_program sp1(group3, main_sub_group3, parg1, arg1, arg2, arg3, arg4, flag1, marg1);
+static po::sub_program sp1(parser, group3, main_sub_group3, parg1, arg1, arg2, arg3, arg4, flag1, marg1);
+
+PO_INIT_MAIN_FILE_WITH_SUB_PROGRAM_SUPPORT(parser);
@@ -0,0 +1,41 @@
+#include <po.h>
+#include "check.h"
+
+// Parses command lines held by the parse result in the /proc/<pid>/cmdline format and checks that the string_view
+// values, the pattern keys and the positionals point into that buffer instead of being copied
+static po::detail::parser parser;
+static po::argument<std::string_view> name{po::ParentGroup(parser), po::LongName("name"), po::Def<std::string_view>("")};
+static po::multi_pattern_argument<std::string_view, std::string_view> defines{po::ParentGroup(parser), po::Pattern("define-*"), po::Min(0)};
+static po::multi_positional_argument<> files{po::ParentGroup(parser), po::Min(0)};
+
+static bool
+    inside(std::string_view view, const std::string& buffer)
+{
+    return view.data() >= buffer.data() && view.data() + view.size() <= buffer.data() + buffer.size();
+}
+
+int main(int, const char**)
+{
+    auto pr = parser.make_result();
+    pr.input().assign("input\0--name=first\0--define-key=value\0a.txt\0b.txt", 49);
+    auto status = parser.try_parse_input(pr);
+    check(status.status() == po::ParseStatus::Match, "the buffer parses");
+    check(pr.program_name() == "input" && inside(pr.program_name(), pr.input()), "the program name is the first argument");
+    check(pr[name] == "first" && inside(pr[name], pr.input()), "--name points into the buffer");
+    auto define = pr[defines].find("key");
+    check(define != pr[defines].end() && define->second == "value", "--define-key is found");
+    check(define != pr[defines].end() && inside(define->first, pr.input()) && inside(define->second, pr.input()),
+        "the pattern key and its value point into the buffer");
+    check(pr[files].size() == 2 && pr[files][1] == "b.txt" && inside(pr[files][1], pr.input()),
+        "the positionals point into the buffer, the last one without a terminating '\\0'");
+
+    // a buffer built from separate arguments, an empty argument stays an argument
+    std::vector<std::string_view> args{"input", "--name=second", "", "c.txt"};
+    pr.assign_input(args);
+    status = parser.try_parse_input(pr);
+    check(status.status() == po::ParseStatus::Match, "the assigned arguments parse");
+    check(pr[name] == "second" && inside(pr[name], pr.input()), "the next parse reads the new buffer");
+    check(pr[defines].empty(), "the next parse forgets the pattern arguments");
+    check(pr[files].size() == 2 && pr[files][0] == "" && pr[files][1] == "c.txt", "the empty argument is kept");
+    return failed;
+}
@@ -0,0 +1,38 @@
+#include <po.h>
+#include "check.h"
+
+// Parses lazy options, whose text is only converted on first access: a value that doesn't convert doesn't fail
+// the parse, but the access and validate, with the option and the token it came from
+static po::detail::parser parser;
+static po::argument<int> level{po::ParentGroup(parser), po::LongName("level"), po::Def<int>(1), po::Lazy(true)};
+static po::multi_argument<int> numbers{po::ParentGroup(parser), po::LongName("number"), po::ShortName('n'), po::Min(0), po::Max(8), po::Lazy(true)};
+
+int main(int, const char**)
+{
+    auto pr = parser.make_result();
+    auto status = parser.try_parse(std::vector<std::string_view>{"lazy", "--level=7", "-n", "1", "--number=2"}, pr);
+    check(status.status() == po::ParseStatus::Match, "valid values parse");
+    check(pr[level] == 7 && pr[level] == 7, "the level converts on access and stays converted");
+    check(pr[numbers].size() == 2 && pr[numbers][0] == 1 && pr[numbers][1] == 2, "the numbers convert on access");
+    check(!pr.try_validate(), "converted values validate");
+
+    status = parser.try_parse(std::vector<std::string_view>{"lazy", "--number=1", "-n", "x", "--level=abc"}, pr);
+    check(status.status() == po::ParseStatus::Match, "values that don't convert don't fail the parse");
+    auto e = pr.try_validate();
+    check(e.code() == po::ErrorCode::InvalidValue && e.name() == "level" && e.token() == 3 && e.text() == "abc",
+        "validate names the option and the token of the first lazy option that doesn't convert");
+    try
+    {
+        pr[numbers];
+        check(false, "accessing a value that doesn't convert throws");
+    }
+    catch (const std::runtime_error& ex)
+    {
+        check(std::string_view(ex.what()) == "po error: invalid value \"x\"", "the access throws the conversion error");
+    }
+
+    status = parser.try_parse(std::vector<std::string_view>{"lazy", "-n", "99999999999"}, pr);
+    e = pr.try_validate();
+    check(e.code() == po::ErrorCode::OutOfRange && e.name() == "number" && e.token() == 1, "a value out of range");
+    return failed;
+}
@@ -0,0 +1,125 @@
+#include <po.h>
+#include "check.h"
+#include <deque>
+
+// Runs the parse machine on an nmcli style After/BindTo chain thousands of groups long and checks that the parse
+// stack stays flat and that the options of the main group are reached again after the chain. Schemas whose options
+// compete for a token list the conflict and throw on the first parse, unless an exact name shadows a pattern
+static po::detail::parser parser;
+static po::flag verbose{po::ParentGroup(parser), po::LongName("verbose"), po::ShortName('v')};
+static po::group up{po::ParentGroup(parser), po::LongName("up")};
+static po::flag ask{po::ParentGroup(up), po::LongName("ask"), po::ShortName('a')};
+static po::positional_argument<> id{po::LongName("<id>"), po::After(up)};
+
+static void
+    check_conflict(po::detail::parser& p, std::string_view token, const po::detail::base_option& taken,
+        const po::detail::base_option& shadowed, std::string_view what)
+{
+    const auto& conflicts = p.conflicts();
+    check(conflicts.size() == 1 && conflicts[0].token == token && conflicts[0].taken == &taken
+        && conflicts[0].shadowed == &shadowed, what);
+    try
+    {
+        p.parse_command_line(std::vector<std::string_view>{"conflict"});
+        check(false, "a parse of a schema with conflicts throws");
+    }
+    catch (const std::runtime_error& e)
+    {
+        check(std::string_view(e.what()) == "po error: \"" + std::string(token) + "\" is used by \"" + std::string(taken.name())
+            + "\" and \"" + std::string(shadowed.name()) + "\"", "the message names the token and both options");
+    }
+}
+
+int main(int, const char**)
+{
+    std::size_t depth = 2000;
+    std::deque<std::string> names;
+    std::deque<po::group> groups;
+    std::deque<po::positional_argument<>> values;
+    std::vector<std::string_view> args{"machine", "up", "-a", "id0"};
+    po::detail::base_group* previous = &id;
+    for (std::size_t i = 0; i < depth; i++)
+    {
+        const auto& name = names.emplace_back("step-" + std::to_string(i));
+        auto& group = groups.emplace_back(po::After(*previous), po::LongName(name));
+        previous = &values.emplace_back(po::LongName("<value>"), po::BindTo(group));
+        args.push_back(name);
+        args.push_back(names.emplace_back("value-" + std::to_string(i)));
+    }
+    args.push_back("--verbose");
+
+    auto pr = parser.make_result();
+    auto status = parser.try_parse(args, pr);
+    check(status.status() == po::ParseStatus::Match, "the chain parses");
+    check(pr[ask] && pr[id] == "id0" && pr[verbose], "the options before, in and after the chain");
+    bool all = true;
+    for (std::size_t i = 0; i < depth && all; i++)
+    {
+        all = pr[groups[i]] && pr[values[i]] == names[i * 2 + 1];
+    }
+    check(all, "every group and value of the chain");
+    check(pr.frames().capacity() < 16, "the parse stack doesn't grow with the chain");
+
+    args.resize(args.size() - 3);
+    args.push_back("--verbose");
+    status = parser.try_parse(args, pr);
+    check(status.status() == po::ParseStatus::Match && pr[verbose] && !pr[groups[depth - 1]], "a chain cut short");
+    status = parser.try_parse(std::vector<std::string_view>{"machine", "up", "id0", "step-1", "x"}, pr);
+    check(!status && status.error().code() == po::ErrorCode::UnknownArgument && status.error().token() == 2,
+        "a group of the chain out of order");
+
+    {
+        po::detail::parser p;
+        po::flag a{po::ParentGroup(p), po::LongName("same")};
+        po::flag b{po::ParentGroup(p), po::LongName("same")};
+        check_conflict(p, "--same", a, b, "a long name used twice");
+    }
+    {
+        po::detail::parser p;
+        po::flag a{po::ParentGroup(p), po::LongName("one"), po::ShortName('x')};
+        po::flag b{po::ParentGroup(p), po::LongName("two"), po::ShortName('x')};
+        check_conflict(p, "-x", a, b, "a short name used twice");
+    }
+    {
+        po::detail::parser p;
+        po::flag a{po::ParentGroup(p), po::LongName("both")};
+        po::group b{po::ParentGroup(p), po::LongName("both")};
+        check_conflict(p, "both", a, b, "an option and a group with the same name");
+    }
+    {
+        po::detail::parser p;
+        po::argument<int> a{po::ParentGroup(p), po::LongName("define-x"), po::Def<int>(0)};
+        po::multi_pattern_argument<std::string_view, int> b{po::ParentGroup(p), po::Pattern("define-*"), po::Min(0)};
+        const auto& conflicts = p.conflicts();
+        check(conflicts.size() == 1 && conflicts[0].token == "--define-x" && conflicts[0].taken == &a
+            && conflicts[0].shadowed == &b && !conflicts[0].fatal, "a long name a pattern matches is listed, but not fatal");
+        auto r = p.make_result();
+        auto s = p.try_parse(std::vector<std::string_view>{"conflict", "--define-x=1", "--define-y=2"}, r);
+        check(s.status() == po::ParseStatus::Match && r[a] == 1 && r[b].size() == 1 && r[b].find("y")->second == 2,
+            "the long name takes its token and the pattern the others");
+    }
+    {
+        po::detail::parser p;
+        po::multi_pattern_argument<std::string_view, int> a{po::ParentGroup(p), po::Pattern("opt-*"), po::Min(0)};
+        po::multi_pattern_argument<std::string_view, int> b{po::ParentGroup(p), po::Pattern("opt-*"), po::Min(0)};
+        check(p.conflicts().size() == 1 && p.conflicts()[0].fatal, "a pattern used twice");
+        try
+        {
+            p.parse_command_line(std::vector<std::string_view>{"conflict"});
+            check(false, "a parse of a schema with a pattern used twice throws");
+        }
+        catch (const std::runtime_error& e)
+        {
+            check(std::string_view(e.what()) == "po error: \"--opt-*\" is used by \"opt-*\" and \"opt-*\"",
+                "the message names the patterns");
+        }
+    }
+    {
+        po::detail::parser p;
+        po::flag a{po::ParentGroup(p), po::LongName("same")};
+        po::group g{po::ParentGroup(p), po::LongName("g")};
+        po::flag b{po::ParentGroup(g), po::LongName("same")};
+        check(p.conflicts().empty(), "the same name in different groups");
+    }
+    return failed;
+}
@@ -13,7 +13,7 @@ static po::argument<std::string> mode{po::ParentGroup(parser), po::LongName("mod
 static po::flag pretty{po::ParentGroup(parser), po::LongName("pretty"), po::ShortName('p')};
 static po::flag show_secrets{po::ParentGroup(parser), po::LongName("show-secrets"), po::ShortName('s')};
 static po::flag terse{po::ParentGroup(parser), po::LongName("terse"), po::ShortName('t')};
-static po::flag version{po::ParentGroup(parser), po::LongName("version"), po::ShortName('s')};
+static po::flag version{po::ParentGroup(parser), po::LongName("version"), po::ShortName('v')};
 static po::optional_argument<std::size_t> wait{po::ParentGroup(parser), po::LongName("wait"), po::ShortName('w')};
 
 static po::group general{po::ParentGroup(parser), po::LongName("general"), po::Desc(
@@ -0,0 +1,47 @@
+#include <po.h>
+#include "check.h"
+#include <iostream>
+
+// Converts a multi_argument with Parallel on the worker pool (while parsing on a single core) and checks that the
+// values keep their order and that the first value that doesn't convert is reported with its token. Runs tasks on
+// the pool directly, also from inside a task
+static po::detail::parser parser;
+static po::multi_argument<std::uint32_t> numbers{po::ParentGroup(parser), po::LongName("number"), po::ShortName('n'), po::Min(0), po::Max(std::size_t(-1)), po::Parallel(64)};
+
+int main(int, const char**)
+{
+    auto& pool = po::detail::worker_pool::instance();
+    std::vector<std::atomic<std::size_t>> calls(100);
+    pool.run(calls.size(), [&](std::size_t t)
+        {
+            calls[t]++;
+            pool.run(4, [&](std::size_t) { calls[t]++; });
+        });
+    check(std::all_of(calls.begin(), calls.end(), [](const auto& c) { return c == 5; }), "every task runs once, nested runs too");
+
+    std::size_t count = 10000;
+    std::vector<std::string> storage;
+    for (std::size_t i = 0; i < count; i++)
+    {
+        storage.push_back("--number=" + std::to_string(i * 7));
+    }
+    std::vector<std::string_view> args{"parallel"};
+    args.insert(args.end(), storage.begin(), storage.end());
+    auto pr = parser.make_result();
+    auto status = parser.try_parse(args, pr);
+    check(status.status() == po::ParseStatus::Match, "the numbers parse");
+    bool ordered = pr[numbers].size() == count;
+    for (std::size_t i = 0; i < count && ordered; i++)
+    {
+        ordered = pr[numbers][i] == i * 7;
+    }
+    check(ordered, "the numbers keep their order");
+
+    args[5001] = "--number=x";
+    args[9001] = "--number=-1";
+    status = parser.try_parse(args, pr);
+    check(!status && status.error().code() == po::ErrorCode::InvalidValue && status.error().token() == 5000
+        && status.error().name() == "number", "the first number that doesn't convert is reported");
+    std::cout << po::detail::worker_pool::concurrency() << " cores\n";
+    return failed;
+}
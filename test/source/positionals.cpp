@@ -0,0 +1,47 @@
+#include <po.h>
+#include "check.h"
+#include <sstream>
+
+// Converts positionals to their type: a single typed positional followed by a typed multi positional, which keeps
+// the command line order and duplicates, and positionals that don't convert
+static po::detail::parser parser;
+static po::flag verbose{po::ParentGroup(parser), po::LongName("verbose"), po::ShortName('v')};
+static po::positional_argument<po::hex<std::uint32_t>> mask{po::ParentGroup(parser), po::LongName("<mask>")};
+static po::multi_positional_argument<double> values{po::After(mask), po::Min(0), po::Reserve(4)};
+
+int main(int, const char**)
+{
+    auto pr = parser.make_result();
+    auto status = parser.try_parse(std::vector<std::string_view>{"positionals", "-v", "7FF", "2.5", "-1", "2.5", "1e3"}, pr);
+    check(status.status() == po::ParseStatus::Match, "the positionals parse");
+    check(pr[verbose] && pr[mask] == 0x7FF, "a hex positional");
+    std::vector<double> expected{2.5, -1, 2.5, 1e3};
+    check(std::equal(pr[values].begin(), pr[values].end(), expected.begin(), expected.end()),
+        "the values in command line order with the duplicate");
+    check(pr[values].capacity() >= 4, "the values are reserved");
+
+    status = parser.try_parse(std::vector<std::string_view>{"positionals", "1F"}, pr);
+    check(status.status() == po::ParseStatus::Match && pr[mask] == 0x1F && pr[values].empty(), "no values");
+
+    status = parser.try_parse(std::vector<std::string_view>{"positionals", "xyz", "1"}, pr);
+    check(!status && status.error().code() == po::ErrorCode::InvalidValue && status.error().token() == 0,
+        "a positional that doesn't convert is an error");
+
+    status = parser.try_parse(std::vector<std::string_view>{"positionals", "1", "2", "abc"}, pr);
+    check(!status && status.error().code() == po::ErrorCode::InvalidValue && status.error().token() == 2
+        && status.error().text() == "abc", "a value that doesn't convert names its token");
+
+    status = parser.try_parse(std::vector<std::string_view>{"positionals", "100000000"}, pr);
+    check(!status && status.error().code() == po::ErrorCode::OutOfRange, "a value out of range");
+
+    auto round_trip = [](auto value)
+    {
+        std::ostringstream os;
+        os << value;
+        return po::lexical_cast<decltype(value)>(os.str()) == value ? os.str() : "";
+    };
+    check(round_trip(po::hex<std::uint32_t>(0x7FF)) == "0x7ff" && round_trip(po::oct<std::uint32_t>(8)) == "010"
+        && round_trip(po::bin<std::uint8_t>(5)) == "0b101" && round_trip(po::bin<std::uint64_t>(~0ull)) == "0b" + std::string(64, '1'),
+        "hex, oct and bin values print in their base and parse back");
+    return failed;
+}
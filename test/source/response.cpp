@@ -0,0 +1,63 @@
+#include <po.h>
+#include "check.h"
+#include <fstream>
+
+// Expands @response files written to a scratch folder: whitespace and '\0' separated files, nested files relative
+// to the including one, a loop of files including each other and a file that doesn't exist
+static po::detail::parser parser;
+static po::argument<std::string_view> name{po::ParentGroup(parser), po::LongName("name"), po::Def<std::string_view>("")};
+static po::multi_argument<std::string_view> labels{po::ParentGroup(parser), po::LongName("label"), po::Min(0), po::Max(8)};
+static po::multi_positional_argument<> files{po::ParentGroup(parser), po::Min(0)};
+
+static void
+    write(const std::filesystem::path& path, std::string_view content)
+{
+    std::ofstream(path, std::ios::binary).write(content.data(), content.size());
+}
+
+int main(int, const char**)
+{
+    auto dir = std::filesystem::temp_directory_path() / ("po_response_" + std::to_string(::getpid()));
+    std::filesystem::create_directories(dir / "nested");
+    write(dir / "main.rsp", "--name=outer\n  @nested/inner.rsp\t--label=f\n");
+    write(dir / "nested" / "inner.rsp", std::string_view("--label=a\0--label=b c\0@more.rsp\0", 32));
+    write(dir / "nested" / "more.rsp", "--label=d");
+    write(dir / "loop1.rsp", "first.txt @loop2.rsp");
+    write(dir / "loop2.rsp", "second.txt @loop1.rsp");
+    write(dir / "missing.rsp", "--label=a @does_not_exist.rsp");
+    write(dir / "twice.rsp", "@nested/more.rsp @nested/more.rsp");
+
+    parser.set_response_files(true);
+    auto pr = parser.make_result();
+    std::string main_file = "@" + (dir / "main.rsp").string();
+    std::vector<std::string_view> args{"response", "--label=e", main_file, "last.txt"};
+    auto status = parser.try_parse(args, pr);
+    check(status.status() == po::ParseStatus::Match, "the nested files parse");
+    check(pr[name] == "outer", "an option from the outer file");
+    std::vector<std::string_view> expected_labels{"e", "a", "b c", "d", "f"};
+    check(std::equal(pr[labels].begin(), pr[labels].end(), expected_labels.begin(), expected_labels.end()),
+        "the labels in command line order, a '\\0' separated file keeps blanks");
+    check(pr[files].size() == 1 && pr[files][0] == "last.txt", "the argument after the response file");
+
+    std::string twice_file = "@" + (dir / "twice.rsp").string();
+    status = parser.try_parse(std::vector<std::string_view>{"response", twice_file}, pr);
+    check(status.status() == po::ParseStatus::Match && pr[labels].size() == 2, "a file included twice isn't a loop");
+
+    std::string loop_file = "@" + (dir / "loop1.rsp").string();
+    status = parser.try_parse(std::vector<std::string_view>{"response", loop_file}, pr);
+    check(!status && status.error().code() == po::ErrorCode::ResponseFileLoop, "a loop is an error");
+    check(status.error().message() == "po error: response file \"" + (dir / "loop1.rsp").string() + "\" includes itself",
+        "the loop error names the file included again");
+
+    std::string missing_file = "@" + (dir / "missing.rsp").string();
+    status = parser.try_parse(std::vector<std::string_view>{"response", missing_file}, pr);
+    check(!status && status.error().code() == po::ErrorCode::ResponseFileOpen, "a missing nested file is an error");
+    check(status.error().message() == "po error: could not open response file \"" + (dir / "does_not_exist.rsp").string() + "\"",
+        "the error names the missing file with the path of the including file");
+
+    status = parser.try_parse(std::vector<std::string_view>{"response", "@"}, pr);
+    check(status.status() == po::ParseStatus::Match && pr[files].size() == 1 && pr[files][0] == "@", "a lone @ is an argument");
+
+    std::filesystem::remove_all(dir);
+    return failed;
+}
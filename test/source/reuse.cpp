@@ -0,0 +1,48 @@
+#include <po.h>
+#include "check.h"
+#include <iostream>
+
+// Parses several command lines with the same parser through the string_view span entry point and checks that
+// every parse starts from scratch, that reset forgets the last one and that the containers keep their capacity
+static po::detail::parser parser;
+static po::flag verbose{po::ParentGroup(parser), po::LongName("verbose"), po::ShortName('v')};
+static po::argument<int> level{po::ParentGroup(parser), po::LongName("level"), po::ShortName('l'), po::Def<int>(1)};
+static po::multi_argument<std::string_view> labels{po::ParentGroup(parser), po::LongName("label"), po::Min(0), po::Max(8)};
+static po::multi_positional_argument<> files{po::ParentGroup(parser), po::Min(0)};
+
+int main(int, const char**)
+{
+    try
+    {
+        const auto& r = parser.result();
+        std::vector<std::string_view> first{"reuse", "-v", "--level=3", "--label=a", "--label=b", "f1", "f2", "f3"};
+        parser.parse_command_line(first);
+        parser.notify();
+        check(verbose && level == 3, "first parse reads -v and --level");
+        check(r[labels].size() == 2 && r[files].size() == 3, "first parse collects all values");
+
+        std::vector<std::string_view> second{"reuse", "--label=c", "f4"};
+        parser.parse_command_line(second);
+        parser.notify();
+        check(!verbose && level == 1, "second parse doesn't see the flag and the level of the first one");
+        check(r[labels].size() == 1 && r[labels][0] == "c", "second parse only holds its own label");
+        check(r[files].size() == 1 && r[files][0] == "f4", "second parse only holds its own file");
+
+        auto capacity = r[files].capacity();
+        parser.reset();
+        check(r[files].empty() && r[labels].empty(), "reset forgets the values");
+        check(r[files].capacity() == capacity, "reset keeps the capacity");
+
+        // a result of its own leaves the one of parse_command_line untouched
+        auto pr = parser.make_result();
+        parser.parse(first, pr);
+        check(pr[verbose] && pr[level] == 3 && pr[files].size() == 3, "parse into a separate result");
+        check(!verbose && r[files].empty(), "the result of parse_command_line is untouched");
+    }
+    catch (const std::runtime_error& e)
+    {
+        std::cout << e.what() << "\n";
+        failed = 1;
+    }
+    return failed;
+}
@@ -0,0 +1,68 @@
+#include <po.h>
+#include "check.h"
+#include <iostream>
+
+static int
+    main_connection_up(bool ask, std::string_view id, std::string_view ifname)
+{
+    std::cout << "connection up " << id << " on " << ifname << (ask ? " (ask)" : "") << "\n";
+    return 0;
+}
+static int
+    main_connection_down(std::string_view id)
+{
+    std::cout << "connection down " << id << "\n";
+    return 0;
+}
+
+using cli = po::schema<
+    po::spec::flag<"terse", 't'>,
+    po::spec::argument<std::size_t, "wait", 'w', false>,
+    po::spec::group<"connection",
+        po::spec::sub_program<"up", main_connection_up,
+            po::spec::flag<"ask", 'a'>,
+            po::spec::argument<std::string_view, "uuid">,
+            po::spec::argument<std::string_view, "ifname">>,
+        po::spec::sub_program<"down", main_connection_down,
+            po::spec::argument<std::string_view, "id">>>>;
+
+// Options of the enclosing groups are matched after a group, parsing then goes on in the group of the option
+static void
+    check_scopes()
+{
+    cli::result r;
+    auto e = cli::try_parse(std::vector<std::string_view>{"schema", "connection", "up", "--uuid", "1", "-t", "-w", "3"}, r);
+    check(!e && r.get<"terse">() && r.get<"wait">() == 3 && r.get<"uuid">() == "1", "root options after a group");
+    e = cli::try_parse(std::vector<std::string_view>{"schema", "connection", "up", "-a", "down", "--id", "eth0"}, r);
+    check(!e && r.get<"ask">() && r.parsed<"down">() && r.get<"id">() == "eth0", "a sibling group after a group");
+    e = cli::try_parse(std::vector<std::string_view>{"schema", "connection", "up", "-t", "--uuid", "1"}, r);
+    check(e.code() == po::ErrorCode::UnknownArgument && e.token() == 3, "the options of a group that was left");
+    e = cli::try_parse(std::vector<std::string_view>{"schema", "--uuid", "1"}, r);
+    check(e.code() == po::ErrorCode::UnknownArgument && e.token() == 0, "the options of a group that wasn't entered");
+    e = cli::try_parse(std::vector<std::string_view>{"schema", "connection", "up", "--wait=x"}, r);
+    check(e.code() == po::ErrorCode::InvalidValue && e.token() == 2 && e.text() == "x", "a value that doesn't convert");
+    e = cli::try_parse(std::vector<std::string_view>{"schema", "connection", "down", "--id"}, r);
+    check(e.code() == po::ErrorCode::MissingValue && e.name() == "id", "a missing value");
+    e = cli::try_parse(std::vector<std::string_view>{"schema", "--ask"}, r);
+    check(e.code() == po::ErrorCode::UnknownArgument, "an option of a group before the group");
+    e = cli::try_parse(std::vector<std::string_view>{"schema", "connection", "up", "--uuid", "1"}, r);
+    check(!e && cli::try_notify(r).code() == po::ErrorCode::TooFewArguments && cli::try_notify(r).name() == "ifname",
+        "a required argument of a parsed group");
+}
+
+int main(int argc, const char** argv)
+{
+    check_scopes();
+    try
+    {
+        auto r = cli::parse(argc, argv);
+        cli::notify(r);
+        std::cout << "terse " << r.get<"terse">() << ", wait " << r.get<"wait">() << "\n";
+        return cli::execute_main(r).value_or(0) | failed;
+    }
+    catch (const std::runtime_error& err)
+    {
+        std::cout << err.what() << "\n";
+        return 1;
+    }
+}
@@ -0,0 +1,79 @@
+#include <po.h>
+#include "check.h"
+#include <cstring>
+#include <iostream>
+
+// Splits command lines with shell quoting into words and parses them with parse_line, including the error of a
+// quote that isn't closed
+static po::detail::parser parser;
+static po::argument<std::string_view> name{po::ParentGroup(parser), po::LongName("name"), po::Def<std::string_view>("")};
+static po::multi_positional_argument<> files{po::ParentGroup(parser), po::Min(0)};
+
+// Words of line joined by '|'
+static std::string
+    split(std::string_view line, char& quote)
+{
+    std::string buffer(line);
+    buffer.resize(po::detail::split_command_line(buffer.data(), buffer.size(), quote));
+    std::string result;
+    for (std::size_t pos = 0; pos < buffer.size(); pos += std::strlen(buffer.data() + pos) + 1)
+    {
+        result += (pos == 0 ? "" : "|") + std::string(buffer.data() + pos);
+    }
+    return result;
+}
+
+int main(int, const char**)
+{
+    struct query
+    {
+        std::string_view line;
+        std::string_view expected;
+        char quote;
+    };
+    std::vector<query> queries{
+        {"  a   b\tc  ", "a|b|c", 0},
+        {"'a b' \"c d\"", "a b|c d", 0},
+        {"'a\\b' \"a\\b\"", "a\\b|a\\b", 0},
+        {"\"\\$\\`\\\"\\\\\"", "$`\"\\", 0},
+        {"a\\ b \\'c\\'", "a b|'c'", 0},
+        {"a\\\nb", "ab", 0},
+        {"x'y'\"z\"", "xyz", 0},
+        {"'' \"\"", "|", 0},
+        {"'it''s'", "its", 0},
+        {"a 'b c", "a|b c", '\''},
+        {"a \"b", "a|b", '"'}};
+    for (const auto& q : queries)
+    {
+        char quote = 0;
+        auto words = split(q.line, quote);
+        if (words != q.expected || quote != q.quote)
+        {
+            std::cout << "splitting \"" << q.line << "\": got \"" << words << "\" quote " << int(quote)
+                << ", expected \"" << q.expected << "\" quote " << int(q.quote) << "\n";
+            failed = 1;
+        }
+    }
+
+    auto pr = parser.make_result();
+    auto status = parser.try_parse_line("split --name='a b' \"file 1\" file\\ 2", pr);
+    check(status.status() == po::ParseStatus::Match, "the line parses");
+    check(pr.program_name() == "split", "the first word is the program name");
+    check(pr[name] == "a b", "a quoted value");
+    check(pr[files].size() == 2 && pr[files][0] == "file 1" && pr[files][1] == "file 2", "quoted and escaped positionals");
+
+    status = parser.try_parse_line("split --name=\"a b", pr);
+    check(!status && status.error().code() == po::ErrorCode::MissingClosingQuote, "an open quote is an error");
+    check(status.error().message() == "po error: missing closing \" in command line", "the error names the quote");
+    check(pr[files].empty(), "nothing is parsed from a line with an open quote");
+    try
+    {
+        parser.parse_line("split 'a");
+        check(false, "parse_line throws for an open quote");
+    }
+    catch (const std::runtime_error& e)
+    {
+        check(std::string_view(e.what()) == "po error: missing closing ' in command line", "parse_line throws the message");
+    }
+    return failed;
+}
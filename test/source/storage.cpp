@@ -0,0 +1,75 @@
+#include <po.h>
+#include "check.h"
+
+// Fills the same keyed settings into the ordered, flat and hashed storage of multi_pattern_argument and checks
+// lookup by std::string_view, that a later key replaces an earlier one, the iteration order of each storage and
+// that a second parse starts empty
+static po::detail::parser parser;
+static po::multi_pattern_argument<std::string, int> ordered{po::ParentGroup(parser), po::Pattern("ordered-*"), po::Min(0)};
+static po::multi_pattern_argument<std::string, int, po::flat_storage> flat{po::ParentGroup(parser), po::Pattern("flat-*"), po::Min(0), po::Reserve(8)};
+static po::multi_pattern_argument<std::string_view, int, po::hash_storage> hashed{po::ParentGroup(parser), po::Pattern("hash-*"), po::Min(0)};
+
+template <class Map>
+static std::string
+    join(const Map& map)
+{
+    std::string result;
+    for (const auto& [key, value] : map)
+    {
+        result += (result.empty() ? "" : " ") + std::string(key) + "=" + std::to_string(value);
+    }
+    return result;
+}
+
+int main(int, const char**)
+{
+    std::vector<std::string> settings;
+    for (std::string storage : {"ordered", "flat", "hash"})
+    {
+        for (std::string setting : {"-c=3", "-a=1", "-b=2", "-a=4"})
+        {
+            settings.push_back("--" + storage + setting);
+        }
+    }
+    std::vector<std::string_view> args{"storage"};
+    args.insert(args.end(), settings.begin(), settings.end());
+    auto pr = parser.make_result();
+    auto status = parser.try_parse(args, pr);
+    check(status.status() == po::ParseStatus::Match, "the settings parse");
+    check(join(pr[ordered]) == "a=4 b=2 c=3", "ordered storage is sorted, the later a wins");
+    check(join(pr[flat]) == "a=4 b=2 c=3", "flat storage is sorted once after parsing, the later a wins");
+    check(join(pr[hashed]) == "c=3 a=4 b=2", "hash storage keeps the insertion order, the later a wins");
+    check(pr[ordered].find(std::string_view("b"))->second == 2 && pr[flat].at(std::string_view("b")) == 2 && pr[hashed].at("b") == 2,
+        "lookup by std::string_view");
+    check(!pr[flat].contains(std::string_view("d")) && pr[hashed].find("d") == pr[hashed].end(), "a missing key");
+    try
+    {
+        pr[flat].at(std::string_view("d"));
+        check(false, "at throws for a missing key");
+    }
+    catch (const std::out_of_range&)
+    {
+    }
+
+    // enough keys to grow the hash table several times
+    std::vector<std::string> storage;
+    std::vector<std::string_view> many{"storage"};
+    std::size_t count = 1000;
+    storage.reserve(count);
+    for (std::size_t i = 0; i < count; i++)
+    {
+        storage.push_back("--hash-key" + std::to_string(i) + "=" + std::to_string(i));
+        many.push_back(storage.back());
+    }
+    status = parser.try_parse(many, pr);
+    check(status.status() == po::ParseStatus::Match, "many settings parse");
+    check(pr[ordered].empty() && pr[flat].empty(), "a second parse starts empty");
+    bool found = pr[hashed].size() == count;
+    for (std::size_t i = 0; i < count && found; i++)
+    {
+        auto key = "key" + std::to_string(i);
+        found = pr[hashed].contains(std::string_view(key)) && pr[hashed].at(std::string_view(key)) == int(i);
+    }
+    check(found, "every key is found after growing");
+    return failed;
+}
@@ -0,0 +1,50 @@
+#include <po.h>
+#include "check.h"
+#include <fstream>
+
+// Streams typed positionals from a long response file to a callback and checks that the values arrive converted
+// and in order, that the tokens of the parse don't grow with the number of arguments and that a value which
+// doesn't convert ends the parse with the index of its token
+static std::vector<std::uint32_t> received;
+static po::detail::parser parser;
+static po::flag verbose{po::ParentGroup(parser), po::LongName("verbose"), po::ShortName('v')};
+static po::multi_positional_argument<std::uint32_t> ids{po::ParentGroup(parser), po::Min(0), po::OnArgument<std::uint32_t>([](std::uint32_t id)
+    {
+        received.push_back(id);
+    })};
+
+int main(int, const char**)
+{
+    std::size_t count = 100000;
+    auto path = std::filesystem::temp_directory_path() / ("po_streaming_" + std::to_string(::getpid()) + ".rsp");
+    {
+        std::ofstream file(path);
+        for (std::size_t i = 0; i < count; i++)
+        {
+            file << i << '\n';
+        }
+    }
+
+    parser.set_response_files(true);
+    auto pr = parser.make_result();
+    std::string file_argument = "@" + path.string();
+    std::vector<std::string_view> args{"streaming", "-v", file_argument, "4294967295"};
+    received.reserve(count + 1);
+    auto status = parser.try_parse(args, pr);
+    check(status.status() == po::ParseStatus::Match, "the response file parses");
+    check(pr[verbose], "the flag before the positionals");
+    check(received.size() == count + 1 && received[count - 1] == count - 1 && received[count] == 4294967295u,
+        "every value arrives converted and in order");
+    check(pr[ids].empty(), "the values aren't collected");
+    check(pr.tokens().capacity() < 16, "the tokens don't grow with the number of arguments");
+
+    received.clear();
+    std::vector<std::string_view> invalid{"streaming", "1", "2", "x", "4"};
+    status = parser.try_parse(invalid, pr);
+    check(!status && status.error().code() == po::ErrorCode::InvalidValue, "a value that doesn't convert is an error");
+    check(status.error().token() == 2 && status.error().text() == "x", "the error points to the token");
+    check(received.size() == 2, "the values before the error arrive");
+
+    std::filesystem::remove(path);
+    return failed;
+}
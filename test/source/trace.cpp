@@ -0,0 +1,85 @@
+#include <po.h>
+#include "check.h"
+#include <iostream>
+#include <sstream>
+
+// Compiled with PO_TRACE, records the events of a parse and checks them and the totals trace_totals prints: one
+// Begin and one End, a Lookup for every option token, the options and groups that were parsed and the
+// followers of a group
+static_assert(po::detail::trace_enabled, "the trace test has to be compiled with PO_TRACE");
+
+static po::detail::parser parser;
+static po::flag verbose{po::ParentGroup(parser), po::LongName("verbose"), po::ShortName('v')};
+static po::argument<int> level{po::ParentGroup(parser), po::LongName("level"), po::Def<int>(1)};
+static po::group run{po::ParentGroup(parser), po::LongName("run")};
+static po::flag force{po::ParentGroup(run), po::LongName("force"), po::ShortName('f')};
+static po::positional_argument<> file{po::ParentGroup(run), po::LongName("<file>")};
+
+class recorder
+    : public po::trace_sink
+{
+public:
+    virtual void
+        event(const po::trace_event& e) override
+    {
+        events.push_back(e);
+    }
+    std::size_t
+        count(po::TraceKind kind) const
+    {
+        return std::count_if(events.begin(), events.end(), [kind](const po::trace_event& e) { return e.kind == kind; });
+    }
+    bool
+        parsed(const po::detail::base_option& option, std::size_t token) const
+    {
+        return std::any_of(events.begin(), events.end(), [&](const po::trace_event& e)
+            {
+                return e.kind == po::TraceKind::Parsed && e.option == &option && e.token == token && e.status == po::ParseStatus::Match;
+            });
+    }
+
+    std::vector<po::trace_event> events;
+};
+
+int main(int, const char**)
+{
+    std::vector<std::string_view> args{"trace", "-v", "--level=3", "run", "--force", "a.txt"};
+    recorder events;
+    auto pr = parser.make_result();
+    pr.set_trace_sink(&events);
+    auto status = parser.try_parse(args, pr);
+    check(status.status() == po::ParseStatus::Match && pr[force] && pr[file] == "a.txt", "the traced parse");
+    check(!events.events.empty() && events.events.front().kind == po::TraceKind::Begin
+        && events.events.back().kind == po::TraceKind::End && events.count(po::TraceKind::Begin) == 1
+        && events.count(po::TraceKind::End) == 1, "the parse is framed by Begin and End");
+    check(events.events.back().token == 5 && events.events.back().status == po::ParseStatus::Match, "End counts the tokens");
+    check(events.parsed(verbose, 0) && events.parsed(level, 1) && events.parsed(run, 2) && events.parsed(force, 3)
+        && events.parsed(file, 4), "every option and the group are parsed at their token");
+
+    std::ostringstream out;
+    po::trace_totals totals(out);
+    pr.set_trace_sink(&totals);
+    status = parser.try_parse(args, pr);
+    auto& t = totals.last();
+    check(t.tokens == 5 && t.lookups == events.count(po::TraceKind::Lookup)
+        && t.parsed == events.count(po::TraceKind::Parsed), "trace_totals counts the events");
+    std::size_t comparisons = 0;
+    std::size_t depth = 0;
+    for (const auto& e : events.events)
+    {
+        comparisons += e.kind == po::TraceKind::Lookup ? e.comparisons : 0;
+        depth = e.kind == po::TraceKind::Follow ? std::max(depth, e.depth) : depth;
+    }
+    check(t.comparisons == comparisons && t.depth == depth && depth > 0, "trace_totals sums the comparisons and the depth");
+    // every token is looked up once, "run" finds the group with the same lookup that finds no option, and the
+    // positional takes the place of the group on the stack
+    check(out.str() == "po trace: 5 tokens, 5 lookups, 5 comparisons, 5 parsed, follower depth 1\n",
+        "trace_totals prints the totals at End");
+
+    std::size_t before = events.events.size();
+    pr.set_trace_sink(nullptr);
+    status = parser.try_parse(args, pr);
+    check(status.status() == po::ParseStatus::Match && events.events.size() == before, "no events without a sink");
+    std::cout << out.str();
+    return failed;
+}